@@ -0,0 +1,259 @@
+﻿#pragma once
+
+#include <new>
+
+namespace pde_solvers {
+
+/// @brief Невладеющее представление профиля, лежащего в чужой памяти (см. arena_profile_collection_t)
+/// Интерфейс доступа совпадает с std::vector, поэтому представление можно подставлять
+/// в profile_wrapper вместо vector<T> и в солверы, работающие с data() и size() 
+/// (например, fv_subcycling_solver_t). Присваивание копирует значения, как у vector; 
+/// копирование и перемещение представления запрещены - привязка к памяти меняется только rebind. 
+/// За концом профиля есть выравнивающий хвост (padded_size),
+/// заполненный нулями, - векторизованные циклы могут идти до padded_size без отдельной обработки остатка
+/// @tparam T Тип значения в точке
+template <typename T>
+class profile_span_t {
+protected:
+    /// @brief Начало профиля
+    T* values{ nullptr };
+    /// @brief Количество значений профиля
+    size_t count{ 0 };
+    /// @brief Количество значений вместе с выравнивающим хвостом
+    size_t padded_count{ 0 };
+public:
+    profile_span_t() = default;
+    profile_span_t(T* values, size_t count, size_t padded_count)
+        : values(values)
+        , count(count)
+        , padded_count(padded_count)
+    {}
+    profile_span_t(const profile_span_t&) = delete;
+    profile_span_t(profile_span_t&&) = delete;
+    /// @brief Копирование значений (как у std::vector). Размеры профилей должны совпадать
+    profile_span_t& operator=(const profile_span_t& other) {
+        assign(other.begin(), other.end());
+        return *this;
+    }
+    /// @brief Копирование значений из обычного профиля. Размеры профилей должны совпадать
+    profile_span_t& operator=(const vector<T>& other) {
+        assign(other.begin(), other.end());
+        return *this;
+    }
+    /// @brief Копирование значений из диапазона. Размеры профилей должны совпадать
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        if (static_cast<size_t>(std::distance(first, last)) != count) {
+            throw std::logic_error("Profile span size mismatch");
+        }
+        std::copy(first, last, values);
+    }
+    /// @brief Привязка к другому участку памяти (значения не копируются)
+    void rebind(T* values, size_t count, size_t padded_count) {
+        this->values = values;
+        this->count = count;
+        this->padded_count = padded_count;
+    }
+    /// @brief Копия значений в виде обычного профиля
+    vector<T> to_vector() const {
+        return vector<T>(begin(), end());
+    }
+
+    size_t size() const {
+        return count;
+    }
+    /// @brief Количество значений вместе с выравнивающим хвостом
+    size_t padded_size() const {
+        return padded_count;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    T* data() {
+        return values;
+    }
+    const T* data() const {
+        return values;
+    }
+    T& operator[](size_t index) {
+        return values[index];
+    }
+    const T& operator[](size_t index) const {
+        return values[index];
+    }
+    T& at(size_t index) {
+        if (index >= count) {
+            throw std::out_of_range("Profile span index out of range");
+        }
+        return values[index];
+    }
+    const T& at(size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("Profile span index out of range");
+        }
+        return values[index];
+    }
+    T& front() {
+        return values[0];
+    }
+    const T& front() const {
+        return values[0];
+    }
+    T& back() {
+        return values[count - 1];
+    }
+    const T& back() const {
+        return values[count - 1];
+    }
+    T* begin() {
+        return values;
+    }
+    T* end() {
+        return values + count;
+    }
+    const T* begin() const {
+        return values;
+    }
+    const T* end() const {
+        return values + count;
+    }
+};
+
+/// @brief Указатели на представления профилей, хранящиеся в array (аналог для vector см. в profile_structures.h)
+template <size_t Dimension, typename DataType>
+inline array<profile_span_t<DataType>*, Dimension> get_profiles_pointers(array<profile_span_t<DataType>, Dimension>& profiles)
+{
+    return create_array<Dimension>([&](int dimension) { return &profiles[dimension]; });
+}
+
+/// @brief Слой скалярных профилей на точках и ячейках в одном выровненном блоке памяти
+/// Аналог profile_collection_t без векторных профилей: на слой делается одно выделение памяти
+/// вместо отдельного выделения на каждый профиль. Каждый профиль начинается на границе
+/// arena_alignment байт и дополнен нулями до кратного ей размера
+/// @tparam PointScalar Количество скалярных профилей на точках
+/// @tparam CellScalar Количество скалярных профилей на ячейках
+/// @tparam Scalar Тип хранения
+template <size_t PointScalar, size_t CellScalar = 0, typename Scalar = double>
+class arena_profile_collection_t {
+public:
+    /// @brief Выравнивание профилей, байт (строка кэша, AVX-512)
+    static constexpr size_t arena_alignment = 64;
+    /// @brief Тип хранения скалярных профилей
+    typedef Scalar scalar_type;
+    typedef profile_span_t<Scalar> profile_type;
+protected:
+    /// @brief Освобождение выровненной памяти
+    struct arena_deleter_t {
+        void operator()(Scalar* data) const {
+            ::operator delete(data, std::align_val_t(arena_alignment));
+        }
+    };
+    /// @brief Количество точек
+    size_t point_count;
+    /// @brief Общий блок памяти всех профилей слоя
+    std::unique_ptr<Scalar[], arena_deleter_t> arena;
+public:
+    /// @brief Список скалярных профилей на границах ячеек
+    array<profile_type, PointScalar> point_double;
+    /// @brief Список скалярных профилей в ячейках
+    array<profile_type, CellScalar> cell_double;
+protected:
+    /// @brief Размер профиля, дополненный до кратного arena_alignment
+    static size_t get_padded_size(size_t size) {
+        constexpr size_t values_per_line = arena_alignment / sizeof(Scalar);
+        return (size + values_per_line - 1) / values_per_line * values_per_line;
+    }
+    /// @brief Размер блока памяти на все профили слоя
+    size_t get_arena_size() const {
+        return PointScalar * get_padded_size(point_count) + CellScalar * get_padded_size(point_count ? point_count - 1 : 0);
+    }
+    /// @brief Выделение блока памяти, заполненного нулями
+    void allocate() {
+        size_t arena_size = get_arena_size();
+        Scalar* data = static_cast<Scalar*>(
+            ::operator new(std::max<size_t>(1, arena_size) * sizeof(Scalar), std::align_val_t(arena_alignment)));
+        std::fill(data, data + arena_size, Scalar());
+        arena.reset(data);
+    }
+    /// @brief Привязка представлений профилей к блоку памяти
+    void bind_profiles() {
+        Scalar* data = arena.get();
+        size_t point_padded = get_padded_size(point_count);
+        for (profile_type& profile : point_double) {
+            profile.rebind(data, point_count, point_padded);
+            data += point_padded;
+        }
+        size_t cell_count = point_count ? point_count - 1 : 0;
+        size_t cell_padded = get_padded_size(cell_count);
+        for (profile_type& profile : cell_double) {
+            profile.rebind(data, cell_count, cell_padded);
+            data += cell_padded;
+        }
+    }
+public:
+    arena_profile_collection_t(size_t point_count)
+        : point_count(point_count)
+    {
+        allocate();
+        bind_profiles();
+    }
+    arena_profile_collection_t(const arena_profile_collection_t& other)
+        : point_count(other.point_count)
+    {
+        allocate();
+        std::copy(other.arena.get(), other.arena.get() + get_arena_size(), arena.get());
+        bind_profiles();
+    }
+    /// @brief Перемещение не меняет адреса профилей: представления нового слоя привязываются
+    /// к той же памяти, представления исходного слоя отвязываются
+    arena_profile_collection_t(arena_profile_collection_t&& other) noexcept
+        : point_count(other.point_count)
+        , arena(std::move(other.arena))
+    {
+        for (size_t index = 0; index < PointScalar; ++index) {
+            profile_type& profile = other.point_double[index];
+            point_double[index].rebind(profile.data(), profile.size(), profile.padded_size());
+            profile.rebind(nullptr, 0, 0);
+        }
+        for (size_t index = 0; index < CellScalar; ++index) {
+            profile_type& profile = other.cell_double[index];
+            cell_double[index].rebind(profile.data(), profile.size(), profile.padded_size());
+            profile.rebind(nullptr, 0, 0);
+        }
+        other.point_count = 0;
+    }
+    arena_profile_collection_t& operator=(const arena_profile_collection_t& other) {
+        if (this != &other) {
+            if (point_count != other.point_count || !arena) {
+                point_count = other.point_count;
+                allocate();
+                bind_profiles();
+            }
+            std::copy(other.arena.get(), other.arena.get() + get_arena_size(), arena.get());
+        }
+        return *this;
+    }
+
+    /// @brief Скалярные профили на границах ячеек (то же, что point_double)
+    array<profile_type, PointScalar>& point_scalar() {
+        return point_double;
+    }
+    /// @brief Скалярные профили на границах ячеек (то же, что point_double)
+    const array<profile_type, PointScalar>& point_scalar() const {
+        return point_double;
+    }
+    /// @brief Скалярные профили в ячейках (то же, что cell_double)
+    array<profile_type, CellScalar>& cell_scalar() {
+        return cell_double;
+    }
+    /// @brief Скалярные профили в ячейках (то же, что cell_double)
+    const array<profile_type, CellScalar>& cell_scalar() const {
+        return cell_double;
+    }
+
+    profile_type& get_point_profile(size_t profile_index) {
+        return point_double[profile_index];
+    }
+};
+
+}
@@ -0,0 +1,215 @@
+﻿#pragma once
+
+#include <fstream>
+#include <cstdint>
+
+namespace pde_solvers {
+
+/// @brief Версия двоичного формата точки восстановления расчета
+constexpr uint32_t checkpoint_format_version = 1;
+
+/// @brief Сигнатура файла точки восстановления расчета
+constexpr char checkpoint_signature[8] = { 'P', 'D', 'E', 'C', 'K', 'P', 'T', '\0' };
+
+/// @brief Запись значения простого типа
+template <typename T>
+inline std::enable_if_t<std::is_arithmetic<T>::value> checkpoint_write(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// @brief Чтение значения простого типа
+template <typename T>
+inline std::enable_if_t<std::is_arithmetic<T>::value> checkpoint_read(std::istream& is, T& value)
+{
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!is) {
+        throw std::runtime_error("Checkpoint is truncated");
+    }
+}
+
+/// @brief Запись профиля: количество значений, размер значения и все значения одним блоком
+/// Значения профиля (double, array<double, N>) должны допускать побайтовое копирование
+template <typename T>
+inline void checkpoint_write(std::ostream& os, const vector<T>& profile)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Profile values must be trivially copyable");
+    checkpoint_write(os, static_cast<uint64_t>(profile.size()));
+    checkpoint_write(os, static_cast<uint32_t>(sizeof(T)));
+    os.write(reinterpret_cast<const char*>(profile.data()), profile.size() * sizeof(T));
+}
+
+/// @brief Чтение профиля, записанного checkpoint_write. Размер профиля берется из файла
+template <typename T>
+inline void checkpoint_read(std::istream& is, vector<T>& profile)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Profile values must be trivially copyable");
+    uint64_t size;
+    uint32_t value_size;
+    checkpoint_read(is, size);
+    checkpoint_read(is, value_size);
+    if (value_size != sizeof(T)) {
+        throw std::runtime_error("Checkpoint profile value type mismatch");
+    }
+    profile.resize(static_cast<size_t>(size));
+    is.read(reinterpret_cast<char*>(profile.data()), profile.size() * sizeof(T));
+    if (!is) {
+        throw std::runtime_error("Checkpoint is truncated");
+    }
+}
+
+/// @brief Запись списка профилей
+template <typename T, size_t Count>
+inline void checkpoint_write(std::ostream& os, const array<vector<T>, Count>& profiles)
+{
+    for (const vector<T>& profile : profiles) {
+        checkpoint_write(os, profile);
+    }
+}
+
+/// @brief Чтение списка профилей
+template <typename T, size_t Count>
+inline void checkpoint_read(std::istream& is, array<vector<T>, Count>& profiles)
+{
+    for (vector<T>& profile : profiles) {
+        checkpoint_read(is, profile);
+    }
+}
+
+/// @brief Запись всех профилей слоя, включая векторные
+template <size_t PointScalar, size_t CellScalar, size_t PointVector, size_t PointVectorDimension,
+    size_t CellVector, size_t CellVectorDimension, typename Scalar>
+inline void checkpoint_write(std::ostream& os, const profile_collection_t<PointScalar, CellScalar,
+    PointVector, PointVectorDimension, CellVector, CellVectorDimension, Scalar>& layer)
+{
+    checkpoint_write(os, layer.point_double);
+    checkpoint_write(os, layer.cell_double);
+    checkpoint_write(os, layer.point_vector);
+    checkpoint_write(os, layer.cell_vector);
+}
+
+/// @brief Чтение всех профилей слоя, включая векторные
+template <size_t PointScalar, size_t CellScalar, size_t PointVector, size_t PointVectorDimension,
+    size_t CellVector, size_t CellVectorDimension, typename Scalar>
+inline void checkpoint_read(std::istream& is, profile_collection_t<PointScalar, CellScalar,
+    PointVector, PointVectorDimension, CellVector, CellVectorDimension, Scalar>& layer)
+{
+    checkpoint_read(is, layer.point_double);
+    checkpoint_read(is, layer.cell_double);
+    checkpoint_read(is, layer.point_vector);
+    checkpoint_read(is, layer.cell_vector);
+}
+
+/// @brief Запись составного слоя: целевые переменные и все специфические слои
+template <typename VarLayer, typename... SpecificLayers>
+inline void checkpoint_write(std::ostream& os, const composite_layer_t<VarLayer, SpecificLayers...>& layer)
+{
+    checkpoint_write(os, layer.vars);
+    std::apply([&](const SpecificLayers&... specific) {
+        (checkpoint_write(os, specific), ...);
+        }, layer.specific);
+}
+
+/// @brief Чтение составного слоя
+template <typename VarLayer, typename... SpecificLayers>
+inline void checkpoint_read(std::istream& is, composite_layer_t<VarLayer, SpecificLayers...>& layer)
+{
+    checkpoint_read(is, layer.vars);
+    std::apply([&](SpecificLayers&... specific) {
+        (checkpoint_read(is, specific), ...);
+        }, layer.specific);
+}
+
+/// @brief Запись буфера: количество слоев, индекс текущего слоя и все слои
+template <typename LayerType>
+inline void checkpoint_write(std::ostream& os, const ring_buffer_t<LayerType>& buffer)
+{
+    const vector<LayerType>& layers = buffer.get_layers();
+    checkpoint_write(os, static_cast<uint64_t>(layers.size()));
+    checkpoint_write(os, static_cast<uint64_t>(buffer.get_current_layer_index()));
+    for (const LayerType& layer : layers) {
+        checkpoint_write(os, layer);
+    }
+}
+
+/// @brief Чтение буфера. Количество слоев в буфере должно совпадать с сохраненным
+template <typename LayerType>
+inline void checkpoint_read(std::istream& is, ring_buffer_t<LayerType>& buffer)
+{
+    uint64_t layer_count;
+    uint64_t current_layer;
+    checkpoint_read(is, layer_count);
+    checkpoint_read(is, current_layer);
+    if (layer_count != buffer.get_layers().size()) {
+        throw std::runtime_error("Checkpoint layer count mismatch");
+    }
+    // при нулевом текущем слое смещение offset соответствует индексу слоя во внутреннем буфере
+    buffer.set_current_layer_index(0);
+    for (size_t index = 0; index < layer_count; ++index) {
+        checkpoint_read(is, buffer[static_cast<int>(index)]);
+    }
+    buffer.set_current_layer_index(static_cast<size_t>(current_layer));
+}
+
+/// @brief Сохраняет точку восстановления расчета: буфер слоев и, если задано,
+/// положение курсора временных рядов (см. vector_timeseries_t::get_cursor)
+/// Формат: сигнатура, версия, буфер, курсор. Профили пишутся блоками без преобразования,
+/// поэтому файл переносим только между платформами с одинаковым порядком байт
+/// @param filename Имя файла
+/// @param buffer Буфер слоев
+/// @param timeseries_cursor Курсор временных рядов (может отсутствовать)
+template <typename LayerType>
+inline void save_checkpoint(const std::string& filename, const ring_buffer_t<LayerType>& buffer,
+    const vector<size_t>* timeseries_cursor = nullptr)
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) {
+        throw std::runtime_error("Cannot create checkpoint file " + filename);
+    }
+    os.write(checkpoint_signature, sizeof(checkpoint_signature));
+    checkpoint_write(os, checkpoint_format_version);
+    checkpoint_write(os, buffer);
+
+    vector<uint64_t> cursor;
+    if (timeseries_cursor != nullptr) {
+        cursor.assign(timeseries_cursor->begin(), timeseries_cursor->end());
+    }
+    checkpoint_write(os, cursor);
+    if (!os) {
+        throw std::runtime_error("Cannot write checkpoint file " + filename);
+    }
+}
+
+/// @brief Восстанавливает расчет из точки, сохраненной save_checkpoint
+/// Буфер должен быть создан заранее с тем же количеством слоев
+/// @param filename Имя файла
+/// @param buffer Буфер слоев
+/// @param timeseries_cursor Курсор временных рядов (если нужен)
+template <typename LayerType>
+inline void load_checkpoint(const std::string& filename, ring_buffer_t<LayerType>* buffer,
+    vector<size_t>* timeseries_cursor = nullptr)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) {
+        throw std::runtime_error("Cannot open checkpoint file " + filename);
+    }
+    char signature[sizeof(checkpoint_signature)];
+    is.read(signature, sizeof(signature));
+    if (!is || !std::equal(signature, signature + sizeof(signature), checkpoint_signature)) {
+        throw std::runtime_error("File " + filename + " is not a checkpoint");
+    }
+    uint32_t version;
+    checkpoint_read(is, version);
+    if (version != checkpoint_format_version) {
+        throw std::runtime_error("Unsupported checkpoint format version");
+    }
+    checkpoint_read(is, *buffer);
+
+    vector<uint64_t> cursor;
+    checkpoint_read(is, cursor);
+    if (timeseries_cursor != nullptr) {
+        timeseries_cursor->assign(cursor.begin(), cursor.end());
+    }
+}
+
+}
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+namespace pde_solvers {
+
+/// @brief Профиль с циклической адресацией точек
+/// Сдвиг профиля на одну точку (перенос при числе Куранта, равном единице) выполняется
+/// за O(1): меняется только начало профиля в буфере и записывается граничная точка
+/// @tparam T Тип значения в точке
+template <typename T = double>
+class circular_profile_t {
+protected:
+    /// @brief Буфер значений
+    vector<T> values;
+    /// @brief Положение нулевой точки профиля в буфере values
+    size_t origin{ 0 };
+
+    /// @brief Индекс в буфере values для точки профиля index
+    size_t buffer_index(size_t index) const {
+        size_t result = origin + index;
+        return result < values.size() ? result : result - values.size();
+    }
+public:
+    /// @brief Профиль из point_count точек, заполненный значением value
+    circular_profile_t(size_t point_count, const T& value = T())
+        : values(point_count, value)
+    {
+    }
+    /// @brief Профиль, инициализированный обычным профилем
+    circular_profile_t(const vector<T>& profile)
+        : values(profile)
+    {
+    }
+    /// @brief Количество точек профиля
+    size_t size() const {
+        return values.size();
+    }
+    T& operator[](size_t index) {
+        return values[buffer_index(index)];
+    }
+    const T& operator[](size_t index) const {
+        return values[buffer_index(index)];
+    }
+    T& front() {
+        return (*this)[0];
+    }
+    const T& front() const {
+        return (*this)[0];
+    }
+    T& back() {
+        return (*this)[values.size() - 1];
+    }
+    const T& back() const {
+        return (*this)[values.size() - 1];
+    }
+
+    /// @brief Сдвиг профиля на одну точку
+    /// @param direction +1: значение из точки i переходит в точку i + 1, 
+    /// в нулевую точку записывается boundary_value; 
+    /// -1: значение из точки i переходит в точку i - 1, в последнюю точку записывается boundary_value
+    /// @param boundary_value Значение, втекающее в профиль с границы
+    void shift(int direction, const T& boundary_value)
+    {
+        size_t n = values.size();
+        if (direction > 0) {
+            origin = origin == 0 ? n - 1 : origin - 1;
+            values[origin] = boundary_value;
+        }
+        else if (direction < 0) {
+            values[origin] = boundary_value;
+            origin = origin + 1 == n ? 0 : origin + 1;
+        }
+    }
+
+    /// @brief Копия профиля в обычном (нециклическом) порядке точек
+    vector<T> get_profile() const
+    {
+        vector<T> result;
+        result.reserve(values.size());
+        result.insert(result.end(), values.begin() + origin, values.end());
+        result.insert(result.end(), values.begin(), values.begin() + origin);
+        return result;
+    }
+
+    /// @brief Заполнение профиля из обычного профиля такой же длины
+    void set_profile(const vector<T>& profile)
+    {
+        if (profile.size() != values.size()) {
+            throw std::runtime_error("circular_profile_t: profile size mismatch");
+        }
+        values = profile;
+        origin = 0;
+    }
+};
+
+}
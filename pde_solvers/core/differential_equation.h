@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include <type_traits>
+#include <typeinfo>
+
 namespace pde_solvers {
 
 /// @brief Дифференциальное уравнение
@@ -14,6 +17,23 @@ public:
 
 
 
+/// @brief Наибольшее по модулю значение переменной ОДУ (скалярный случай)
+inline double max_abs_value(double value)
+{
+    return std::abs(value);
+}
+
+/// @brief Наибольшее по модулю значение переменной ОДУ (векторный случай)
+template <size_t Dimension>
+inline double max_abs_value(const std::array<double, Dimension>& value)
+{
+    double result = 0;
+    for (double v : value) {
+        result = std::max(result, std::abs(v));
+    }
+    return result;
+}
+
 /// @brief Обыкновенное дифференциальное уравнение - базовый класс
 template <size_t Dimension>
 class ode_t : public differential_equation_t<Dimension> {
@@ -29,6 +49,47 @@ public:
     /// @return Значение правой части ОДУ
     virtual right_party_type ode_right_party(
         size_t grid_index, const var_type& point_vector) const = 0;
+
+    /// @brief Правая часть внутри ячейки сетки (для методов, шагающих не по точкам сетки)
+    /// По умолчанию - линейная интерполяция правых частей на границах ячейки. 
+    /// Модели с непрерывным описанием по координате могут переопределить
+    /// @param cell_index Индекс ячейки (левой точки)
+    /// @param cell_fraction Относительное положение внутри ячейки, 0..1
+    /// @param point_vector Переменные u
+    virtual right_party_type ode_right_party_at(size_t cell_index, double cell_fraction,
+        const var_type& point_vector) const
+    {
+        if (cell_fraction <= 0) {
+            return ode_right_party(cell_index, point_vector);
+        }
+        if (cell_fraction >= 1) {
+            return ode_right_party(cell_index + 1, point_vector);
+        }
+        right_party_type left = ode_right_party(cell_index, point_vector);
+        right_party_type right = ode_right_party(cell_index + 1, point_vector);
+        return (1 - cell_fraction) * left + cell_fraction * right;
+    }
+
+    /// @brief Производная правой части по направлению J(u) * du, где J - матрица Якоби правой части
+    /// По умолчанию считается односторонней разностью (одно дополнительное вычисление правой части).
+    /// Модели с известным якобианом могут переопределить
+    /// @param grid_index Индекс точки сетки
+    /// @param point_vector Переменные u
+    /// @param right_party Правая часть f(u), уже посчитанная вызывающей стороной
+    /// @param direction Направление du
+    virtual right_party_type ode_right_party_derivative(size_t grid_index, const var_type& point_vector,
+        const right_party_type& right_party, const var_type& direction) const
+    {
+        double direction_scale = max_abs_value(direction);
+        if (direction_scale == 0) {
+            return 0.0 * right_party;
+        }
+        double h = std::sqrt(std::numeric_limits<double>::epsilon())
+            * std::max(1.0, max_abs_value(point_vector)) / direction_scale;
+        var_type shifted = point_vector + h * direction;
+        right_party_type shifted_party = ode_right_party(grid_index, shifted);
+        return (1 / h) * (shifted_party - right_party);
+    }
 };
 
 
@@ -80,4 +141,87 @@ public:
     }
 };
 
-}
\ No newline at end of file
+
+/// @brief Вызов методов ДУЧП со статической диспетчеризацией
+/// Если Pde - конкретный тип модели (например, PipeModelPGConstArea), то методы вызываются
+/// по квалифицированному имени, минуя таблицу виртуальных функций. Так компилятор может 
+/// встроить вызов в горячий цикл солвера.
+/// Если Pde - абстрактный pde_t<Dimension>, то вызов остается виртуальным
+/// @tparam Pde Тип уравнения
+template <typename Pde>
+struct pde_dispatch_t {
+    /// @brief Признак статической диспетчеризации
+    static constexpr bool is_static = !std::is_abstract_v<Pde>;
+
+    /// @brief Проверяет, что динамический тип модели совпадает с Pde
+    /// Иначе квалифицированный вызов молча обошел бы переопределения в классе-наследнике
+    static void check_dynamic_type(const Pde& pde)
+    {
+        if constexpr (is_static) {
+            if (typeid(pde) != typeid(Pde)) {
+                throw std::logic_error("Static PDE dispatch: model type differs from template parameter");
+            }
+        }
+    }
+
+    template <typename VarType>
+    static auto getEquationsCoeffs(const Pde& pde, size_t grid_index, const VarType& u)
+    {
+        if constexpr (is_static)
+            return pde.Pde::getEquationsCoeffs(grid_index, u);
+        else
+            return pde.getEquationsCoeffs(grid_index, u);
+    }
+
+    template <typename VarType>
+    static auto getSourceTerm(const Pde& pde, size_t grid_index, const VarType& u)
+    {
+        if constexpr (is_static)
+            return pde.Pde::getSourceTerm(grid_index, u);
+        else
+            return pde.getSourceTerm(grid_index, u);
+    }
+
+    template <typename VarType>
+    static auto GetLeftEigens(const Pde& pde, size_t grid_index, const VarType& u)
+    {
+        if constexpr (is_static)
+            return pde.Pde::GetLeftEigens(grid_index, u);
+        else
+            return pde.GetLeftEigens(grid_index, u);
+    }
+};
+
+/// @brief Признак модели с постоянной собственной системой (не зависит ни от координаты, 
+/// ни от значений переменных). Модель объявляет static constexpr bool has_constant_eigens = true
+/// @tparam Pde Тип уравнения
+template <typename Pde, typename = void>
+struct pde_has_constant_eigens : std::false_type {};
+
+template <typename Pde>
+struct pde_has_constant_eigens<Pde, std::void_t<decltype(Pde::has_constant_eigens)>>
+    : std::bool_constant<Pde::has_constant_eigens> {};
+
+/// @brief Признак ОДУ, правая часть которой не зависит от переменных (только от координаты)
+/// Тогда решение методом Эйлера - префиксная сумма приращений по ячейкам (см. solve_euler_scan).
+/// Модель объявляет static constexpr bool has_state_independent_right_party = true
+/// @tparam Ode Тип уравнения
+template <typename Ode, typename = void>
+struct ode_has_state_independent_right_party : std::false_type {};
+
+template <typename Ode>
+struct ode_has_state_independent_right_party<Ode, std::void_t<decltype(Ode::has_state_independent_right_party)>>
+    : std::bool_constant<Ode::has_state_independent_right_party> {};
+
+/// @brief Признак модели переноса, которая считает скорости на границах ячеек для всей трубы сразу,
+/// без вызова getEquationsCoeffs на каждой границе (см. PipeQAdvection::calc_face_velocities)
+/// @tparam Pde Тип уравнения
+template <typename Pde, typename = void>
+struct pde_has_face_velocities : std::false_type {};
+
+template <typename Pde>
+struct pde_has_face_velocities<Pde, std::void_t<decltype(
+    std::declval<const Pde&>().calc_face_velocities(std::declval<std::vector<double>*>()))>>
+    : std::true_type {};
+
+}
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+namespace pde_solvers {
+
+/// @brief Профиль ансамбля сценариев одной и той же трубы
+/// Значения всех сценариев в точке хранятся подряд (сценарий - самый внутренний индекс):
+/// values[point * scenario_count + scenario]. Так проход по точкам обрабатывает 
+/// все сценарии точки в одном непрерывном, удобном для векторизации цикле
+/// @tparam T Тип значения
+template <typename T = double>
+class ensemble_profile_t {
+protected:
+    /// @brief Количество точек профиля
+    size_t point_count{ 0 };
+    /// @brief Количество сценариев
+    size_t scenario_count{ 0 };
+    /// @brief Значения с чередованием по сценариям
+    vector<T> values;
+public:
+    ensemble_profile_t() = default;
+    ensemble_profile_t(size_t point_count, size_t scenario_count, const T& value = T())
+        : point_count(point_count)
+        , scenario_count(scenario_count)
+        , values(point_count * scenario_count, value)
+    {
+    }
+    /// @brief Количество точек профиля
+    size_t size() const {
+        return point_count;
+    }
+    /// @brief Количество сценариев
+    size_t get_scenario_count() const {
+        return scenario_count;
+    }
+    T& operator()(size_t point, size_t scenario) {
+        return values[point * scenario_count + scenario];
+    }
+    const T& operator()(size_t point, size_t scenario) const {
+        return values[point * scenario_count + scenario];
+    }
+    /// @brief Указатель на значения всех сценариев в точке point
+    T* point_data(size_t point) {
+        return values.data() + point * scenario_count;
+    }
+    /// @brief Указатель на значения всех сценариев в точке point
+    const T* point_data(size_t point) const {
+        return values.data() + point * scenario_count;
+    }
+
+    /// @brief Профиль одного сценария
+    vector<T> get_scenario_profile(size_t scenario) const
+    {
+        vector<T> result(point_count);
+        for (size_t point = 0; point < point_count; ++point) {
+            result[point] = (*this)(point, scenario);
+        }
+        return result;
+    }
+    /// @brief Задание профиля одного сценария
+    void set_scenario_profile(size_t scenario, const vector<T>& profile)
+    {
+        if (profile.size() != point_count) {
+            throw std::runtime_error("ensemble_profile_t: profile size mismatch");
+        }
+        for (size_t point = 0; point < point_count; ++point) {
+            (*this)(point, scenario) = profile[point];
+        }
+    }
+    /// @brief Значения всех сценариев в точке (например, на выходе трубы)
+    vector<T> get_point_values(size_t point) const
+    {
+        return vector<T>(point_data(point), point_data(point) + scenario_count);
+    }
+};
+
+/// @brief Аналог profile_collection_t для ансамбля сценариев
+/// Скалярные профили на точках и в ячейках
+template <size_t PointScalar, size_t CellScalar = 0>
+struct ensemble_collection_t
+{
+    /// @brief Список скалярных профилей на границах ячеек
+    array<ensemble_profile_t<double>, PointScalar> point_double;
+    /// @brief Список скалярных профилей в ячейках
+    array<ensemble_profile_t<double>, CellScalar> cell_double;
+
+    ensemble_collection_t(size_t point_count, size_t scenario_count)
+        : point_double{ array_maker<ensemble_profile_t<double>, PointScalar>::make_array(
+            ensemble_profile_t<double>(point_count, scenario_count)) }
+        , cell_double{ array_maker<ensemble_profile_t<double>, CellScalar>::make_array(
+            ensemble_profile_t<double>(point_count - 1, scenario_count)) }
+    {
+    }
+};
+
+}
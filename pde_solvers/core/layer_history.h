@@ -0,0 +1,393 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace pde_solvers {
+
+/// @brief Битовый поток для упакованной истории (см. compressed_profile_history_t)
+class history_bit_stream_t {
+protected:
+    /// @brief Слова потока
+    vector<uint64_t> words;
+    /// @brief Количество записанных бит
+    uint64_t bit_count{ 0 };
+public:
+    /// @brief Количество записанных бит (позиция следующей записи)
+    uint64_t size() const {
+        return bit_count;
+    }
+    /// @brief Объем памяти потока, байт
+    size_t get_bytes() const {
+        return words.size() * sizeof(uint64_t);
+    }
+    /// @brief Записывает младшие bits бит значения value
+    void write(uint64_t value, unsigned bits) {
+        if (bits == 0) {
+            return;
+        }
+        if (bits < 64) {
+            value &= (uint64_t(1) << bits) - 1;
+        }
+        unsigned shift = static_cast<unsigned>(bit_count % 64);
+        if (shift == 0) {
+            words.push_back(0);
+        }
+        words.back() |= value << shift;
+        unsigned written = 64 - shift;
+        if (bits > written) {
+            words.push_back(value >> written);
+        }
+        bit_count += bits;
+    }
+    /// @brief Читает bits бит с позиции position, позиция сдвигается
+    uint64_t read(uint64_t& position, unsigned bits) const {
+        if (bits == 0) {
+            return 0;
+        }
+        size_t word = static_cast<size_t>(position / 64);
+        unsigned shift = static_cast<unsigned>(position % 64);
+        uint64_t result = words[word] >> shift;
+        unsigned available = 64 - shift;
+        if (bits > available) {
+            result |= words[word + 1] << available;
+        }
+        if (bits < 64) {
+            result &= (uint64_t(1) << bits) - 1;
+        }
+        position += bits;
+        return result;
+    }
+};
+
+/// @brief Сжатая история одного профиля (последовательность профилей одинаковой длины)
+/// Каждое значение кодируется относительно значения в той же точке на предыдущем шаге:
+///  - без потерь: XOR двоичных представлений double (как в Gorilla, Pelkonen 2015);
+///  - с ограниченной ошибкой tolerance: разность номеров уровней квантования с шагом 2 * tolerance.
+/// Ненулевое слово записывается как число ведущих нулей, длина значащей части и значащая часть,
+/// нулевое (значение не изменилось) - одним битом.
+/// Каждые keyframe_interval шагов кодирование начинается заново (опорный шаг), а внутри шага
+/// запоминается позиция каждого блока из points_per_block точек. Поэтому для доступа к шагу
+/// декодируются только шаги от ближайшего опорного, а для ряда значений в точке - только блок с этой точкой
+class compressed_profile_history_t {
+public:
+    /// @brief Количество точек в блоке с отдельно запоминаемой позицией
+    static constexpr size_t points_per_block = 64;
+protected:
+    /// @brief Количество точек профиля
+    size_t point_count;
+    /// @brief Допустимая ошибка восстановления (0 - без потерь)
+    double tolerance;
+    /// @brief Период опорных шагов
+    size_t keyframe_interval;
+    /// @brief Количество блоков на шаг
+    size_t block_count;
+    /// @brief Количество записанных шагов
+    size_t step_count{ 0 };
+    /// @brief Упакованные данные
+    history_bit_stream_t stream;
+    /// @brief Позиции блоков: [шаг * block_count + блок]
+    vector<uint64_t> block_positions;
+    /// @brief Слова последнего записанного шага (биты double или номер уровня квантования)
+    vector<uint64_t> last_words;
+protected:
+    /// @brief Слово для значения: биты double или номер уровня квантования
+    /// Номер уровня должен помещаться в int64_t, иначе (и для NaN, бесконечности) - исключение
+    uint64_t to_word(double value) const {
+        if (tolerance > 0) {
+            double level = value / (2 * tolerance);
+            if (!(std::abs(level) < 9.2e18)) {
+                throw std::runtime_error("History value cannot be quantized with given tolerance");
+            }
+            return static_cast<uint64_t>(std::llround(level));
+        }
+        uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        return word;
+    }
+    /// @brief Значение по слову (обратно к to_word)
+    double from_word(uint64_t word) const {
+        if (tolerance > 0) {
+            return static_cast<int64_t>(word) * (2 * tolerance);
+        }
+        double value;
+        std::memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+    /// @brief Разность слов соседних шагов
+    uint64_t encode_delta(uint64_t word, uint64_t previous) const {
+        if (tolerance > 0) {
+            // zigzag: малые по модулю разности дают малые слова
+            int64_t delta = static_cast<int64_t>(word - previous);
+            return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        }
+        return word ^ previous;
+    }
+    /// @brief Слово по разности и слову предыдущего шага (обратно к encode_delta)
+    uint64_t decode_delta(uint64_t delta, uint64_t previous) const {
+        if (tolerance > 0) {
+            uint64_t difference = (delta >> 1) ^ (~(delta & 1) + 1);
+            return previous + difference;
+        }
+        return delta ^ previous;
+    }
+    /// @brief Количество ведущих нулей ненулевого слова
+    static unsigned count_leading_zeros(uint64_t word) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, word);
+        return 63 - static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_clzll(word));
+#endif
+    }
+    /// @brief Количество хвостовых нулей ненулевого слова
+    static unsigned count_trailing_zeros(uint64_t word) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+    }
+    /// @brief Запись разности
+    void write_delta(uint64_t delta) {
+        if (delta == 0) {
+            stream.write(0, 1);
+            return;
+        }
+        unsigned leading = count_leading_zeros(delta);
+        unsigned trailing = count_trailing_zeros(delta);
+        unsigned meaningful = 64 - leading - trailing;
+        stream.write(1, 1);
+        stream.write(leading, 6);
+        stream.write(meaningful - 1, 6);
+        stream.write(delta >> trailing, meaningful);
+    }
+    /// @brief Чтение разности
+    uint64_t read_delta(uint64_t& position) const {
+        if (stream.read(position, 1) == 0) {
+            return 0;
+        }
+        unsigned leading = static_cast<unsigned>(stream.read(position, 6));
+        unsigned meaningful = static_cast<unsigned>(stream.read(position, 6)) + 1;
+        unsigned trailing = 64 - leading - meaningful;
+        return stream.read(position, meaningful) << trailing;
+    }
+    /// @brief Пропуск разности без восстановления
+    void skip_delta(uint64_t& position) const {
+        if (stream.read(position, 1) == 0) {
+            return;
+        }
+        position += 6;
+        position += stream.read(position, 6) + 1;
+    }
+    /// @brief Ближайший опорный шаг не позже step
+    size_t get_keyframe(size_t step) const {
+        return step - step % keyframe_interval;
+    }
+    void check_step(size_t step) const {
+        if (step >= step_count) {
+            throw std::out_of_range("History step is out of range");
+        }
+    }
+public:
+    /// @brief Конструктор
+    /// @param point_count Количество точек профиля
+    /// @param tolerance Допустимая ошибка восстановления (0 - без потерь)
+    /// @param keyframe_interval Период опорных шагов (больше - плотнее упаковка, медленнее доступ)
+    compressed_profile_history_t(size_t point_count, double tolerance = 0, size_t keyframe_interval = 32)
+        : point_count(point_count)
+        , tolerance(tolerance)
+        , keyframe_interval(keyframe_interval)
+        , block_count((point_count + points_per_block - 1) / points_per_block)
+        , last_words(point_count, 0)
+    {
+        if (tolerance < 0 || keyframe_interval == 0) {
+            throw std::logic_error("Wrong history compression settings");
+        }
+    }
+    /// @brief Количество записанных шагов
+    size_t size() const {
+        return step_count;
+    }
+    /// @brief Объем памяти упакованных данных и индекса, байт
+    size_t get_compressed_bytes() const {
+        return stream.get_bytes() + block_positions.size() * sizeof(uint64_t);
+    }
+    /// @brief Проверяет, что профиль может быть записан (размер, диапазон квантования), иначе исключение
+    void check_profile(const vector<double>& profile) const {
+        if (profile.size() != point_count) {
+            throw std::runtime_error("History profile size mismatch");
+        }
+        for (double value : profile) {
+            to_word(value);
+        }
+    }
+    /// @brief Добавляет профиль очередного шага
+    void push_back(const vector<double>& profile) {
+        if (profile.size() != point_count) {
+            throw std::runtime_error("History profile size mismatch");
+        }
+        // все значения переводятся в слова до записи, чтобы при исключении история не менялась
+        vector<uint64_t> words(point_count);
+        for (size_t point = 0; point < point_count; ++point) {
+            words[point] = to_word(profile[point]);
+        }
+        bool keyframe = step_count % keyframe_interval == 0;
+        for (size_t point = 0; point < point_count; ++point) {
+            if (point % points_per_block == 0) {
+                block_positions.push_back(stream.size());
+            }
+            write_delta(encode_delta(words[point], keyframe ? 0 : last_words[point]));
+        }
+        last_words.swap(words);
+        step_count++;
+    }
+    /// @brief Восстанавливает профиль шага step
+    void get_profile(size_t step, vector<double>* profile) const {
+        check_step(step);
+        vector<uint64_t> words(point_count, 0);
+        for (size_t decoded = get_keyframe(step); decoded <= step; ++decoded) {
+            uint64_t position = block_positions[decoded * block_count];
+            for (uint64_t& word : words) {
+                word = decode_delta(read_delta(position), word);
+            }
+        }
+        profile->resize(point_count);
+        for (size_t point = 0; point < point_count; ++point) {
+            (*profile)[point] = from_word(words[point]);
+        }
+    }
+    /// @brief Восстанавливает профиль шага step
+    vector<double> get_profile(size_t step) const {
+        vector<double> result;
+        get_profile(step, &result);
+        return result;
+    }
+    /// @brief Значения в точке point на шагах [step_from, step_to)
+    vector<double> get_point_series(size_t point, size_t step_from, size_t step_to) const {
+        if (point >= point_count) {
+            throw std::out_of_range("History point is out of range");
+        }
+        if (step_from >= step_to) {
+            return {};
+        }
+        check_step(step_to - 1);
+
+        vector<double> result;
+        result.reserve(step_to - step_from);
+        size_t block = point / points_per_block;
+        size_t point_in_block = point % points_per_block;
+        uint64_t word = 0;
+        for (size_t step = get_keyframe(step_from); step < step_to; ++step) {
+            if (step % keyframe_interval == 0) {
+                word = 0;
+            }
+            uint64_t position = block_positions[step * block_count + block];
+            for (size_t skipped = 0; skipped < point_in_block; ++skipped) {
+                skip_delta(position);
+            }
+            word = decode_delta(read_delta(position), word);
+            if (step >= step_from) {
+                result.push_back(from_word(word));
+            }
+        }
+        return result;
+    }
+};
+
+/// @brief Сжатая история слоев profile_collection_t (скалярные профили на точках и ячейках)
+/// Каждый профиль хранится в своей compressed_profile_history_t со своей допустимой ошибкой,
+/// т.к. масштабы профилей различаются (плотность ~1e3, вязкость ~1e-5)
+/// @tparam PointScalar Количество скалярных профилей на точках
+/// @tparam CellScalar Количество скалярных профилей на ячейках
+template <size_t PointScalar, size_t CellScalar = 0>
+class layer_history_t {
+public:
+    typedef profile_collection_t<PointScalar, CellScalar> layer_type;
+protected:
+    /// @brief История профилей на точках
+    vector<compressed_profile_history_t> point_history;
+    /// @brief История профилей в ячейках
+    vector<compressed_profile_history_t> cell_history;
+public:
+    /// @brief Конструктор истории без потерь
+    /// @param point_count Количество точек сетки
+    explicit layer_history_t(size_t point_count)
+        : point_history(PointScalar, compressed_profile_history_t(point_count))
+        , cell_history(CellScalar, compressed_profile_history_t(point_count - 1))
+    {
+    }
+    /// @brief Конструктор истории с ограниченной ошибкой
+    /// @param point_count Количество точек сетки
+    /// @param point_tolerance Допустимые ошибки профилей на точках (0 - без потерь)
+    /// @param cell_tolerance Допустимые ошибки профилей в ячейках (0 - без потерь)
+    /// @param keyframe_interval Период опорных шагов
+    layer_history_t(size_t point_count, 
+        const std::array<double, PointScalar>& point_tolerance, 
+        const std::array<double, CellScalar>& cell_tolerance,
+        size_t keyframe_interval = 32)
+    {
+        for (double tolerance : point_tolerance) {
+            point_history.emplace_back(point_count, tolerance, keyframe_interval);
+        }
+        for (double tolerance : cell_tolerance) {
+            cell_history.emplace_back(point_count - 1, tolerance, keyframe_interval);
+        }
+    }
+    /// @brief Количество записанных слоев
+    size_t size() const {
+        return PointScalar > 0 ? point_history.front().size() : cell_history.front().size();
+    }
+    /// @brief Объем памяти упакованных данных, байт
+    size_t get_compressed_bytes() const {
+        size_t result = 0;
+        for (const auto& history : point_history) {
+            result += history.get_compressed_bytes();
+        }
+        for (const auto& history : cell_history) {
+            result += history.get_compressed_bytes();
+        }
+        return result;
+    }
+    /// @brief Добавляет слой (векторные профили не сохраняются)
+    /// Если какой-либо профиль не может быть записан, исключение выбрасывается до записи всех профилей
+    void push_back(const layer_type& layer) {
+        for (size_t index = 0; index < PointScalar; ++index) {
+            point_history[index].check_profile(layer.point_double[index]);
+        }
+        for (size_t index = 0; index < CellScalar; ++index) {
+            cell_history[index].check_profile(layer.cell_double[index]);
+        }
+        for (size_t index = 0; index < PointScalar; ++index) {
+            point_history[index].push_back(layer.point_double[index]);
+        }
+        for (size_t index = 0; index < CellScalar; ++index) {
+            cell_history[index].push_back(layer.cell_double[index]);
+        }
+    }
+    /// @brief Восстанавливает слой шага step
+    void get_layer(size_t step, layer_type* layer) const {
+        for (size_t index = 0; index < PointScalar; ++index) {
+            point_history[index].get_profile(step, &layer->point_double[index]);
+        }
+        for (size_t index = 0; index < CellScalar; ++index) {
+            cell_history[index].get_profile(step, &layer->cell_double[index]);
+        }
+    }
+    /// @brief История профиля на точках с номером profile_index
+    const compressed_profile_history_t& get_point_history(size_t profile_index) const {
+        return point_history[profile_index];
+    }
+    /// @brief История профиля в ячейках с номером profile_index
+    const compressed_profile_history_t& get_cell_history(size_t profile_index) const {
+        return cell_history[profile_index];
+    }
+};
+
+}
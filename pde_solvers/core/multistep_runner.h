@@ -0,0 +1,76 @@
+﻿#pragma once
+
+namespace pde_solvers {
+
+/// @brief Наблюдатель многошагового расчета, который ничего не делает
+struct no_step_observer_t {
+    template <typename LayerType>
+    void operator()(size_t step_index, double time_step, const LayerType& layer) const
+    {
+    }
+};
+
+/// @brief Многошаговый расчет на кольцевом буфере слоев без пересоздания солверов на каждом шаге
+/// Солверы хранят ссылки на слои, поэтому различных пар "прошлый - новый слой" ровно столько, 
+/// сколько слоев в буфере. Солвер для каждой пары создается один раз в конструкторе,
+/// далее на шаге только сдвигается буфер и берется готовый солвер - без выделения памяти
+/// Буфер нельзя сдвигать в обход раннера, иначе солверы перестанут соответствовать слоям
+/// @tparam Solver Тип солвера
+/// @tparam LayerType Тип слоя буфера
+template <typename Solver, typename LayerType>
+class multistep_runner_t {
+protected:
+    /// @brief Буфер слоев
+    ring_buffer_t<LayerType>& buffer;
+    /// @brief Солверы для каждой пары слоев. Солвер solvers[k] считает слой buffer[k + 1]
+    /// по слою buffer[k] (смещения относительно текущего слоя на момент создания раннера)
+    vector<Solver> solvers;
+    /// @brief Индекс солвера для следующего шага
+    size_t solver_index{ 0 };
+public:
+    /// @brief Создает солверы для всех пар слоев
+    /// @param buffer Буфер слоев
+    /// @param factory Создание солвера по паре слоев factory(prev, curr) -> Solver
+    template <typename Factory>
+    multistep_runner_t(ring_buffer_t<LayerType>& buffer, Factory&& factory)
+        : buffer(buffer)
+    {
+        size_t layer_count = buffer.get_layers().size();
+        solvers.reserve(layer_count);
+        for (size_t index = 0; index < layer_count; ++index) {
+            int offset = static_cast<int>(index);
+            solvers.emplace_back(factory(buffer[offset], buffer[offset + 1]));
+        }
+    }
+
+    /// @brief Солвер, который будет использован на следующем шаге
+    Solver& next_solver() {
+        return solvers[solver_index];
+    }
+
+    /// @brief Расчет заданного количества шагов
+    /// На каждом шаге сдвигает буфер, вызывает step_function для готового солвера, 
+    /// затем передает рассчитанный слой наблюдателю
+    /// @param step_count Количество шагов
+    /// @param step_function Расчет шага step_function(solver, step_index), 
+    /// возвращает фактический шаг по времени
+    /// @param observer Наблюдатель observer(step_index, time_step, buffer.current())
+    /// @return Суммарное время расчета
+    template <typename StepFunction, typename Observer>
+    double run(size_t step_count, StepFunction&& step_function, Observer&& observer)
+    {
+        double time = 0;
+        for (size_t step_index = 0; step_index < step_count; ++step_index) {
+            buffer.advance(+1);
+            Solver& solver = solvers[solver_index];
+            solver_index = (solver_index + 1) % solvers.size();
+
+            double time_step = step_function(solver, step_index);
+            time += time_step;
+            observer(step_index, time_step, buffer.current());
+        }
+        return time;
+    }
+};
+
+}
@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include <exception>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pde_solvers {
+
+/// @brief Настройки многопоточного расчета по точкам сетки
+/// По умолчанию расчет последовательный. Параллельный режим включается явно, 
+/// результат при этом побитово совпадает с последовательным при любом числе потоков
+/// Без OpenMP (компилятор без /openmp, -fopenmp) расчет всегда последовательный
+struct parallel_settings_t {
+    /// @brief Количество потоков. 1 - последовательный расчет, 
+    /// 0 - количество потоков OpenMP по умолчанию
+    int thread_count{ 1 };
+    /// @brief Количество точек в порции, обрабатываемой одним потоком за раз. 
+    /// По умолчанию порция профиля double помещается в L1-кэш
+    size_t chunk_size{ 2048 };
+
+    /// @brief Включен ли параллельный режим
+    bool is_parallel() const {
+        return thread_count != 1;
+    }
+    /// @brief Фактическое количество потоков с учетом thread_count = 0
+    int get_thread_count() const {
+#ifdef _OPENMP
+        return thread_count > 0 ? thread_count : omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+    /// @brief Параллельный расчет на заданном количестве потоков
+    static parallel_settings_t with_threads(int thread_count = 0) {
+        parallel_settings_t result;
+        result.thread_count = thread_count;
+        return result;
+    }
+};
+
+/// @brief Обход диапазона [index_from, index_to) порциями по settings.chunk_size
+/// Порции распределяются по потокам статически. Исключение из любой порции 
+/// пробрасывается вызывающему после завершения обхода
+/// Совместимо с OpenMP 2.0 (MSVC)
+/// @param function Обработчик порции function(begin, end)
+template <typename Function>
+inline void parallel_for_chunks(const parallel_settings_t& settings,
+    size_t index_from, size_t index_to, Function&& function)
+{
+    if (index_to <= index_from)
+        return;
+    size_t chunk_size = std::max<size_t>(settings.chunk_size, 1);
+    if (!settings.is_parallel() || index_to - index_from <= chunk_size) {
+        function(index_from, index_to);
+        return;
+    }
+
+    int chunk_count = static_cast<int>((index_to - index_from + chunk_size - 1) / chunk_size);
+    int thread_count = settings.get_thread_count();
+    std::exception_ptr error;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(thread_count)
+#endif
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        size_t begin = index_from + chunk * chunk_size;
+        size_t end = std::min(begin + chunk_size, index_to);
+        try {
+            function(begin, end);
+        }
+        catch (...) {
+#ifdef _OPENMP
+#pragma omp critical (pde_solvers_parallel_error)
+#endif
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/// @brief Максимум по диапазону [index_from, index_to), рассчитываемый порциями
+/// Максимумы порций сводятся последовательно, поэтому результат не зависит от числа потоков
+/// @param function Обработчик порции, возвращает максимум по порции function(begin, end)
+template <typename Function>
+inline double parallel_max_chunks(const parallel_settings_t& settings,
+    size_t index_from, size_t index_to, Function&& function)
+{
+    size_t chunk_size = std::max<size_t>(settings.chunk_size, 1);
+    if (!settings.is_parallel() || index_to - index_from <= chunk_size) {
+        return function(index_from, index_to);
+    }
+
+    size_t chunk_count = (index_to - index_from + chunk_size - 1) / chunk_size;
+    vector<double> chunk_max(chunk_count);
+
+    parallel_settings_t chunk_settings = settings;
+    chunk_settings.chunk_size = 1;
+    parallel_for_chunks(chunk_settings, 0, chunk_count, [&](size_t chunk_from, size_t chunk_to) {
+        for (size_t chunk = chunk_from; chunk < chunk_to; ++chunk) {
+            size_t begin = index_from + chunk * chunk_size;
+            size_t end = std::min(begin + chunk_size, index_to);
+            chunk_max[chunk] = function(begin, end);
+        }
+    });
+
+    double result = chunk_max[0];
+    for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        result = std::max(result, chunk_max[chunk]);
+    }
+    return result;
+}
+
+}
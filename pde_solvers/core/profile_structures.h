@@ -35,25 +35,26 @@ inline array<vector<DataType>*, Dimension> get_profiles_pointers(array<vector<Da
 /// @brief Собирает из составной профиль
 /// Из скалярных профилей собрать векторный профиль: double -> array<double, Dim>
 /// Из векторных профилей собрать матричный профиль: array<double, Dim> -> array<array<double, Dim>, Dim>
-template <typename T, size_t Dimension>
+/// @tparam Profile Тип профиля: vector<T> или представление профиля из arena_profile_collection_t
+template <typename T, size_t Dimension, typename Profile = vector<T>>
 class profile_wrapper {
 protected:
-    array<vector<T>*, Dimension> profiles;
+    array<Profile*, Dimension> profiles;
 public:
     typedef typename fixed_system_types<Dimension>::var_type vector_type;
 
     const size_t n;
 public:
-    profile_wrapper(vector<double>& profile);
+    profile_wrapper(Profile& profile);
 
-    profile_wrapper(array<vector<T>*, Dimension>* profiles)
+    profile_wrapper(array<Profile*, Dimension>* profiles)
         : profiles(*profiles)
         , n(profiles->front()->size())
     {
 
     }
 
-    profile_wrapper(array<vector<T>*, Dimension> profiles)
+    profile_wrapper(array<Profile*, Dimension> profiles)
         : profiles(profiles)
         , n(profiles.front()->size())
     {
@@ -121,10 +122,10 @@ public:
     {
         return profiles[dimension]->at(profile_index);
     }
-    const vector<T>& profile(size_t profile_index) const {
+    const Profile& profile(size_t profile_index) const {
         return *profiles[profile_index];
     }
-    vector<T>& profile(size_t profile_index) {
+    Profile& profile(size_t profile_index) {
         return *profiles[profile_index];
     }
 
@@ -170,32 +171,54 @@ inline profile_wrapper<double, 1>::profile_wrapper(array<vector<double>*, 1>* pr
 /// Скалярный профиль на точках
 /// Скалярный профиль на ячейках
 /// Векторный профиль (заданной размерности)
+/// Scalar - тип хранения скалярных профилей (например, float для переносимых параметров 
+/// при расчетах, ограниченных пропускной способностью памяти)
 template <size_t PointScalar, size_t CellScalar = 0,
     size_t PointVector = 0, size_t PointVectorDimension = 0,
-    size_t CellVector = 0, size_t CellVectorDimension = 0>
+    size_t CellVector = 0, size_t CellVectorDimension = 0,
+    typename Scalar = double>
 struct profile_collection_t
 {
     typedef typename fixed_system_types<PointVectorDimension>::var_type point_vector_type;
     typedef typename fixed_system_types<CellVectorDimension>::var_type cell_vector_type;
+    /// @brief Тип хранения скалярных профилей
+    typedef Scalar scalar_type;
 
 
-    /// @brief Список скалярных профилей на границах ячеек
-    array<vector<double>, PointScalar> point_double;
-    /// @brief Список скалярных профилей в ячейках
-    array<vector<double>, CellScalar> cell_double;
+    /// @brief Список скалярных профилей на границах ячеек (тип значений - Scalar, не обязательно double)
+    array<vector<Scalar>, PointScalar> point_double;
+    /// @brief Список скалярных профилей в ячейках (тип значений - Scalar, не обязательно double)
+    array<vector<Scalar>, CellScalar> cell_double;
     /// @brief Список векторных профилей на границах ячеек
     array<vector<point_vector_type>, PointVector> point_vector;
     /// @brief Список векторных профилей в ячейках
     array<vector<cell_vector_type>, CellVector> cell_vector;
 
-    vector<double>& get_point_profile(size_t profile_index) {
+    /// @brief Скалярные профили на границах ячеек (то же, что point_double)
+    array<vector<Scalar>, PointScalar>& point_scalar() {
+        return point_double;
+    }
+    /// @brief Скалярные профили на границах ячеек (то же, что point_double)
+    const array<vector<Scalar>, PointScalar>& point_scalar() const {
+        return point_double;
+    }
+    /// @brief Скалярные профили в ячейках (то же, что cell_double)
+    array<vector<Scalar>, CellScalar>& cell_scalar() {
+        return cell_double;
+    }
+    /// @brief Скалярные профили в ячейках (то же, что cell_double)
+    const array<vector<Scalar>, CellScalar>& cell_scalar() const {
+        return cell_double;
+    }
+
+    vector<Scalar>& get_point_profile(size_t profile_index) {
         return point_double[profile_index];
     }
 
     profile_collection_t(size_t point_count)
-        : point_double{ array_maker<vector<double>, PointScalar>::make_array(vector<double>(point_count)) }
+        : point_double{ array_maker<vector<Scalar>, PointScalar>::make_array(vector<Scalar>(point_count)) }
+        , cell_double{ array_maker<vector<Scalar>, CellScalar>::make_array(vector<Scalar>(point_count - 1)) }
         , point_vector{ array_maker<vector<point_vector_type>, PointVector>::make_array(vector<point_vector_type>(point_count)) }
-        , cell_double{ array_maker<vector<double>, CellScalar>::make_array(vector<double>(point_count - 1)) }
         , cell_vector{ array_maker<vector<cell_vector_type>, CellVector>::make_array(vector<cell_vector_type>(point_count)) }
     {
 
@@ -207,12 +230,12 @@ struct profile_collection_t
     /// @param t Время
     /// @param os Поток для вывода
     void print(double t, std::ostream& os) {
-        auto print_vector = [&](const vector<double>& data) {
+        auto print_vector = [&](const vector<Scalar>& data) {
             if (data.empty())
                 return;
             os << data[0];
             std::for_each(data.begin() + 1, data.end(),
-                [&](double value)
+                [&](Scalar value)
                 {
                     os << "; " << value;
                 });
@@ -260,6 +283,12 @@ struct composite_layer_t {
         : vars(point_count)
         , specific((sizeof(SpecificLayers), point_count)...)
     {}
+
+    /// @brief Конструктор для слоев ансамбля сценариев (см. ensemble_collection_t)
+    composite_layer_t(size_t point_count, size_t scenario_count)
+        : vars(point_count, scenario_count)
+        , specific(SpecificLayers(point_count, scenario_count)...)
+    {}
 };
 
 }
\ No newline at end of file
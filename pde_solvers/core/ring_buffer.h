@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+template <typename LayerType, typename Selector>
+class ring_buffer_view_t;
+
 /// @brief Контейнер слоев с удобным доступом при численном расчете задач на ДУЧП и им подобным
 /// Организует циклическую смену буферов
 /// Наиболее типичное использование - организация двух слоев 
@@ -28,6 +31,13 @@ public:
         , current_layer(current_layer)
     {
 
+    }
+    /// @brief Конструктор без копирования слоев
+    ring_buffer_t(vector<LayerType>&& layers, size_t current_layer)
+        : layers(std::move(layers))
+        , current_layer(current_layer)
+    {
+
     }
         
     /// @brief Конструктор с инициализацией буфера слоев по переданному слою layer
@@ -50,6 +60,17 @@ public:
     const vector<LayerType>& get_layers() const {
         return layers;
     }
+    /// @brief Индекс текущего слоя во внутреннем буфере (см. get_layers)
+    size_t get_current_layer_index() const {
+        return current_layer;
+    }
+    /// @brief Задает индекс текущего слоя во внутреннем буфере (восстановление расчета)
+    void set_current_layer_index(size_t index) {
+        if (index >= layers.size()) {
+            throw std::runtime_error("Ring buffer layer index is out of range");
+        }
+        current_layer = index;
+    }
     /// @brief Частный геттер, возвращающий из слоев ячейки
     /// TODO: зачем он нужен, такой частный?
     vector<vector<double>> get_layers_cell_values() const {
@@ -98,8 +119,50 @@ public:
             selected_layers.emplace_back(selector(layer));
         }
 
-        ring_buffer_t<ResultType> result(selected_layers, current_layer);
+        ring_buffer_t<ResultType> result(std::move(selected_layers), current_layer);
         return result;
     }
 
+    /// @brief Создает невладеющее представление буфера, аналог get_buffer_wrapper без выделения памяти
+    /// Селектор применяется при каждом обращении к слою представления, индекс текущего слоя общий с буфером
+    /// @tparam Selector Тип селектора
+    /// @param selector Экземпляр селектора, который из профилей в LayerType формирует обертку слоя
+    template <typename Selector>
+    ring_buffer_view_t<LayerType, Selector> get_buffer_view(Selector selector)
+    {
+        return ring_buffer_view_t<LayerType, Selector>(*this, selector);
+    }
+
+};
+
+/// @brief Невладеющее представление буфера слоев (см. ring_buffer_t::get_buffer_view)
+/// Слои не хранятся: обертка слоя формируется селектором при обращении к current(), previous(), operator[].
+/// Сдвиг представления сдвигает исходный буфер
+/// @tparam LayerType Тип слоя исходного буфера
+/// @tparam Selector Тип селектора, формирующего обертку слоя
+template <typename LayerType, typename Selector>
+class ring_buffer_view_t {
+public:
+    /// @brief Тип обертки слоя
+    typedef std::invoke_result_t<Selector, LayerType&> layer_type;
+protected:
+    /// @brief Исходный буфер
+    ring_buffer_t<LayerType>& buffer;
+    /// @brief Селектор
+    Selector selector;
+public:
+    ring_buffer_view_t(ring_buffer_t<LayerType>& buffer, Selector selector)
+        : buffer(buffer)
+        , selector(selector)
+    {
+    }
+    /// @brief Смещает исходный буфер
+    void advance(int offset) {
+        buffer.advance(offset);
+    }
+    layer_type operator[](int offset) const { return std::invoke(selector, buffer[offset]); }
+    /// @brief Обертка текущего слоя
+    layer_type current() const { return std::invoke(selector, buffer.current()); }
+    /// @brief Обертка предыдущего слоя
+    layer_type previous() const { return std::invoke(selector, buffer.previous()); }
 };
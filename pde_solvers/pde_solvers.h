@@ -13,6 +13,13 @@
 #include "core/ring_buffer.h"
 #include "core/differential_equation.h"
 #include "core/profile_structures.h"
+#include "core/arena_profile.h"
+#include "core/parallel_settings.h"
+#include "core/circular_profile.h"
+#include "core/ensemble_profile.h"
+#include "core/multistep_runner.h"
+#include "core/checkpoint.h"
+#include "core/layer_history.h"
 
 #include "solvers/moc_solver.h"
 #include "solvers/ode_solver.h"
@@ -22,6 +29,7 @@
 
 #include "pipe/oil.h"
 #include "pipe/pipe_hydraulic_computations.h"
+#include "pipe/hydraulic_resistance_table.h"
 #include "pipe/pipe_hydraulic_struct.h"
 #include "pipe/pipe_hydraulic_pde.h"
 #include "pipe/pipe_profile_utils.h"
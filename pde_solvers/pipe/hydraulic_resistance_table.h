@@ -0,0 +1,243 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+
+namespace pde_solvers {
+
+/// @brief Кусочно-полиномиальная (Чебышев) аппроксимация hydraulic_resistance_isaev
+/// для заданной относительной шероховатости
+/// Переходная зона [2320, 4000) делится на отрезки равной длины, зона Исаева [4000, 560/Ke) -
+/// на отрезки, границы которых задаются старшими битами двоичного представления Re
+/// (mantissa_bits отрезков на октаву), поэтому номер отрезка находится без логарифма.
+/// На каждом отрезке - разложение по полиномам Чебышева степени degree, вычисляется схемой Кленшоу.
+/// В зоне Шифринсона значение постоянно и хранится как отрезок нулевой степени, ламинарная зона считается по формуле.
+/// Расчет для массива (evaluate) считает каждое значение так же, как operator(), находя таблицу один раз.
+/// Максимальная относительная ошибка проверяется при построении таблицы (get_max_relative_error),
+/// для шероховатостей 1e-6..1e-1 она составляет около 2e-10
+class hydraulic_resistance_table_t {
+public:
+    /// @brief Количество старших бит мантиссы в номере отрезка зоны Исаева (2^3 = 8 отрезков на октаву)
+    static constexpr unsigned mantissa_bits = 3;
+    /// @brief Степень полинома на отрезке
+    static constexpr size_t degree = 5;
+    /// @brief Количество отрезков переходной зоны
+    static constexpr size_t transition_segment_count = 16;
+    /// @brief Границы зон по числу Рейнольдса
+    static constexpr double Re_laminar = 2320;
+    static constexpr double Re_turbulent = 4000;
+protected:
+    /// @brief Отрезок аппроксимации: Re = start + (s + 1) / scale, s in [-1, 1]
+    struct segment_t {
+        /// @brief Коэффициенты разложения по полиномам Чебышева
+        array<double, degree + 1> coeffs;
+        /// @brief Начало отрезка
+        double start;
+        /// @brief Обратная половина длины отрезка
+        double scale;
+    };
+
+    /// @brief Относительная шероховатость
+    double relative_roughness;
+    /// @brief Граница зоны Шифринсона
+    double Re_rough;
+    /// @brief Значение по Шифринсону
+    double lambda_rough;
+    /// @brief Номер (старшие биты Re) первого отрезка зоны Исаева
+    uint64_t first_code;
+    /// @brief Отрезки подряд: переходная зона, зона Исаева, зона Шифринсона (один отрезок нулевой степени)
+    vector<segment_t> segments;
+    /// @brief Номер отрезка зоны Шифринсона
+    size_t rough_segment_index;
+    /// @brief Максимальная относительная ошибка, найденная при построении
+    double max_relative_error{ 0 };
+
+    /// @brief Старшие биты двоичного представления положительного числа
+    static uint64_t get_code(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits >> (52 - mantissa_bits);
+    }
+    /// @brief Число, соответствующее началу отрезка с заданным кодом
+    static double get_code_start(uint64_t code) {
+        uint64_t bits = code << (52 - mantissa_bits);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    /// @brief Разложение функции f на отрезке [a, b] по значениям в узлах Чебышева
+    template <typename Function>
+    static segment_t fit_segment(double a, double b, Function f) {
+        constexpr size_t node_count = degree + 1;
+        array<double, node_count> values;
+        for (size_t k = 0; k < node_count; ++k) {
+            double theta = M_PI * (k + 0.5) / node_count;
+            values[k] = f(a + (b - a) * (std::cos(theta) + 1) / 2);
+        }
+        segment_t segment;
+        for (size_t j = 0; j < node_count; ++j) {
+            double sum = 0;
+            for (size_t k = 0; k < node_count; ++k) {
+                sum += values[k] * std::cos(M_PI * j * (k + 0.5) / node_count);
+            }
+            segment.coeffs[j] = 2.0 / node_count * sum;
+        }
+        segment.coeffs[0] /= 2;
+        segment.start = a;
+        segment.scale = 2 / (b - a);
+        return segment;
+    }
+    /// @brief Значение разложения на отрезке (схема Кленшоу)
+    static double evaluate_segment(const segment_t& segment, double Re) {
+        double s = (Re - segment.start) * segment.scale - 1;
+        double b1 = 0;
+        double b2 = 0;
+        for (size_t j = degree; j > 0; --j) {
+            double b0 = 2 * s * b1 - b2 + segment.coeffs[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        return s * b1 - b2 + segment.coeffs[0];
+    }
+    /// @brief Проверка ошибки на отрезке [start, start + length) по равномерной сетке
+    /// Правый конец не проверяется: на границах зон формула Исаева разрывна
+    void check_segment(const segment_t& segment) {
+        constexpr size_t sample_count = 32;
+        double length = 2 / segment.scale;
+        for (size_t k = 0; k < sample_count; ++k) {
+            double Re = segment.start + length * k / sample_count;
+            double exact = hydraulic_resistance_isaev(Re, relative_roughness);
+            double error = std::abs(evaluate_segment(segment, Re) - exact) / exact;
+            max_relative_error = std::max(max_relative_error, error);
+        }
+    }
+    /// @brief Номер отрезка для Re >= Re_laminar
+    /// Номера для всех зон считаются без ветвлений, нужный выбирается условным присваиванием
+    size_t get_segment_index(double Re) const {
+        constexpr double transition_scale = transition_segment_count / (Re_turbulent - Re_laminar);
+        double transition_position = std::min<double>(transition_segment_count - 1,
+            std::max(0.0, (Re - Re_laminar) * transition_scale));
+        size_t transition = static_cast<size_t>(static_cast<int64_t>(transition_position));
+        size_t turbulent = transition_segment_count + static_cast<size_t>(get_code(Re) - first_code);
+        return Re < Re_turbulent
+            ? transition
+            : Re < Re_rough ? turbulent : rough_segment_index;
+    }
+public:
+    /// @brief Построение таблицы
+    /// @param relative_roughness Относительная шероховатость
+    hydraulic_resistance_table_t(double relative_roughness)
+        : relative_roughness(relative_roughness)
+        , Re_rough(560 / relative_roughness)
+        , lambda_rough(0.11 * pow(relative_roughness, 0.25))
+    {
+        if (Re_rough <= Re_turbulent) {
+            throw std::runtime_error("Relative roughness is too large for tabulated hydraulic resistance");
+        }
+        auto isaev = [&](double Re) { return hydraulic_resistance_isaev(Re, relative_roughness); };
+
+        double transition_length = (Re_turbulent - Re_laminar) / transition_segment_count;
+        for (size_t index = 0; index < transition_segment_count; ++index) {
+            double a = Re_laminar + index * transition_length;
+            segments.push_back(fit_segment(a, a + transition_length, isaev));
+            check_segment(segments.back());
+        }
+
+        first_code = get_code(Re_turbulent);
+        uint64_t last_code = get_code(Re_rough);
+        for (uint64_t code = first_code; code <= last_code; ++code) {
+            double a = std::max(Re_turbulent, get_code_start(code));
+            double b = std::min(Re_rough, get_code_start(code + 1));
+            if (a >= b) {
+                // Re_rough совпал с началом отрезка
+                b = a * 2;
+            }
+            segments.push_back(fit_segment(a, b, isaev));
+            check_segment(segments.back());
+        }
+
+        segment_t rough_segment;
+        rough_segment.coeffs.fill(0);
+        rough_segment.coeffs[0] = lambda_rough;
+        rough_segment.start = 0;
+        rough_segment.scale = 0;
+        rough_segment_index = segments.size();
+        segments.push_back(rough_segment);
+    }
+    /// @brief Относительная шероховатость, для которой построена таблица
+    double get_relative_roughness() const {
+        return relative_roughness;
+    }
+    /// @brief Максимальная относительная ошибка, найденная при построении
+    double get_max_relative_error() const {
+        return max_relative_error;
+    }
+    /// @brief Коэффициент гидравлического сопротивления
+    double operator()(double reynolds_number) const {
+        double Re = std::abs(reynolds_number);
+        if (Re < Re_laminar) {
+            return 64 / std::max(Re, 1.0);
+        }
+        return evaluate_segment(segments[get_segment_index(Re)], std::min(Re, Re_rough));
+    }
+    /// @brief Расчет для массива чисел Рейнольдса
+    /// Каждое значение считается тем же путем, что operator() (результаты совпадают побитово).
+    /// Выигрыш по сравнению с поэлементным вызовом hydraulic_resistance_isaev_tabulated - 
+    /// таблица ищется один раз на массив. Блочный вариант со сбором коэффициентов отрезков 
+    /// в массивы по степеням оказался медленнее поэлементного
+    /// @param reynolds_number Числа Рейнольдса
+    /// @param lambda Коэффициенты гидравлического сопротивления
+    /// @param count Количество значений
+    void evaluate(const double* reynolds_number, double* lambda, size_t count) const {
+        for (size_t index = 0; index < count; ++index) {
+            lambda[index] = (*this)(reynolds_number[index]);
+        }
+    }
+};
+
+/// @brief Таблица текущего потока для заданной шероховатости
+/// Таблицы строятся при первом обращении и хранятся по шероховатостям, поэтому расчет нескольких 
+/// труб с разной шероховатостью не перестраивает таблицы. При большом количестве разных шероховатостей
+/// кэш очищается. Последняя запрошенная таблица возвращается без поиска
+inline const hydraulic_resistance_table_t& get_hydraulic_resistance_table(double relative_roughness)
+{
+    constexpr size_t max_table_count = 32;
+    thread_local std::map<double, std::unique_ptr<hydraulic_resistance_table_t>> tables;
+    thread_local const hydraulic_resistance_table_t* last_table = nullptr;
+    if (last_table != nullptr && last_table->get_relative_roughness() == relative_roughness) {
+        return *last_table;
+    }
+    auto table = tables.find(relative_roughness);
+    if (table == tables.end()) {
+        if (tables.size() >= max_table_count) {
+            tables.clear();
+        }
+        table = tables.emplace(relative_roughness,
+            std::make_unique<hydraulic_resistance_table_t>(relative_roughness)).first;
+    }
+    last_table = table->second.get();
+    return *last_table;
+}
+
+/// @brief Табличный аналог hydraulic_resistance_isaev, подставляется в pipe_properties::resistance_function
+/// @param reynolds_number Число Рейнольдса
+/// @param relative_roughness Относительная шероховатость
+inline double hydraulic_resistance_isaev_tabulated(double reynolds_number, double relative_roughness)
+{
+    return get_hydraulic_resistance_table(relative_roughness)(reynolds_number);
+}
+
+/// @brief Табличный расчет гидравлического сопротивления для массива чисел Рейнольдса
+/// @param reynolds_number Числа Рейнольдса
+/// @param relative_roughness Относительная шероховатость
+/// @param lambda Коэффициенты гидравлического сопротивления
+/// @param count Количество значений
+inline void hydraulic_resistance_isaev_tabulated(const double* reynolds_number, double relative_roughness,
+    double* lambda, size_t count)
+{
+    get_hydraulic_resistance_table(relative_roughness).evaluate(reynolds_number, lambda, count);
+}
+
+}
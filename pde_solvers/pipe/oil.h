@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <cstring>
+
 /// @brief Точка вискограммы
 struct viscosity_data_point {
     double temperature;
@@ -235,6 +237,100 @@ struct viscosity_table_model_t {
 
 
 
+/// @brief Пакетный расчет профиля вязкости по профилям коэффициентов viscosity_table_model_t::reconstruct и температуры
+/// Вязкость пересчитывается только в точках, где с прошлого вызова изменилась температура или партия (коэффициенты).
+/// Пересчитываемые точки группируются по виду модели, аргументы экспонент собираются в непрерывный массив
+/// и экспонента считается одним циклом без ветвлений
+class viscosity_profile_evaluator_t {
+protected:
+    /// @brief Температуры предыдущего расчета
+    vector<double> cached_temperature;
+    /// @brief Коэффициенты предыдущего расчета
+    vector<array<double, 3>> cached_coeffs;
+    /// @brief Индексы точек, в которых вязкость считается через экспоненту
+    vector<size_t> exp_points;
+    /// @brief Множители перед экспонентой
+    vector<double> exp_factors;
+    /// @brief Аргументы экспоненты
+    vector<double> exp_arguments;
+
+    /// @brief Побитовое сравнение коэффициентов (NaN - признак вида модели, его сравнение через == не работает)
+    static bool same_coeffs(const array<double, 3>& a, const array<double, 3>& b) {
+        return std::memcmp(a.data(), b.data(), sizeof(a)) == 0;
+    }
+public:
+    /// @brief Расчет профиля вязкости
+    /// @param coeffs Профиль коэффициентов viscosity_table_model_t::reconstruct
+    /// @param temperature Профиль температуры
+    /// @param viscosity Профиль вязкости. Значения в точках без изменений не перезаписываются,
+    /// поэтому между вызовами один и тот же профиль нельзя менять извне
+    /// @return Количество пересчитанных точек
+    size_t calc(const vector<array<double, 3>>& coeffs, const vector<double>& temperature,
+        vector<double>* viscosity)
+    {
+        size_t point_count = coeffs.size();
+        if (temperature.size() != point_count) {
+            throw std::logic_error("Viscosity coefficients and temperature profiles size mismatch");
+        }
+        if (cached_temperature.size() != point_count || viscosity->size() != point_count) {
+            reset();
+            cached_temperature.resize(point_count, std::numeric_limits<double>::quiet_NaN());
+            cached_coeffs.resize(point_count);
+            viscosity->resize(point_count);
+        }
+
+        exp_points.clear();
+        exp_factors.clear();
+        exp_arguments.clear();
+        size_t changed_count = 0;
+        for (size_t index = 0; index < point_count; ++index) {
+            double T = temperature[index];
+            const array<double, 3>& c = coeffs[index];
+            if (T == cached_temperature[index] && same_coeffs(c, cached_coeffs[index])) {
+                continue;
+            }
+            cached_temperature[index] = T;
+            cached_coeffs[index] = c;
+            changed_count++;
+
+            if (!std::isnan(c[2])) {
+                // Фогель-Фульчер-Тамман
+                exp_points.push_back(index);
+                exp_factors.push_back(c[0]);
+                exp_arguments.push_back(c[2] / (T - c[1]));
+            }
+            else if (!std::isnan(c[1])) {
+                // Филонов-Рейнольс
+                exp_points.push_back(index);
+                exp_factors.push_back(c[0]);
+                exp_arguments.push_back(-c[1] * (T - viscosity_table_model_t::viscosity_temperatures[1]));
+            }
+            else {
+                // Константа
+                (*viscosity)[index] = c[0];
+            }
+        }
+
+        size_t exp_count = exp_points.size();
+        const double* factors = exp_factors.data();
+        double* arguments = exp_arguments.data();
+        for (size_t k = 0; k < exp_count; ++k) {
+            arguments[k] = factors[k] * exp(arguments[k]);
+        }
+        for (size_t k = 0; k < exp_count; ++k) {
+            (*viscosity)[exp_points[k]] = arguments[k];
+        }
+        return changed_count;
+    }
+    /// @brief Сброс кэша: следующий вызов calc пересчитает все точки
+    void reset() {
+        cached_temperature.clear();
+        cached_coeffs.clear();
+    }
+};
+
+
+
 /// @brief Динамические (пересчитываемые в процессе расчета) параметры нефти
 /// @tparam DataBuffer Задается vector<double> для профилей, double для точечного случая
 template <typename BufferDensity, typename BufferViscosity>
@@ -308,6 +404,15 @@ struct fluid_properties_profile_t :
             viscosity_table_model_t::calc(viscosity_approximation[grid_index], temperature);
         return result;
     }
+    /// @brief Профиль вязкости по профилю температуры
+    /// @param temperature Профиль температуры
+    /// @param evaluator Пакетный расчет с кэшем (пересчитывает только изменившиеся точки)
+    /// @param viscosity Профиль вязкости
+    void get_viscosity_profile(const vector<double>& temperature,
+        viscosity_profile_evaluator_t* evaluator, vector<double>* viscosity) const
+    {
+        evaluator->calc(viscosity_approximation, temperature, viscosity);
+    }
 
 };
 
@@ -31,6 +31,19 @@ public:
         return pipe.profile.coordinates;
     }
 
+    /// @brief Скорости потока на границах ячеек (в точках сетки) для всей трубы
+    /// Считаются один раз на шаг, далее используются солвером без виртуальных вызовов
+    /// (см. fv_solver_t::step_variable_velocity)
+    /// @param velocity Скорости в точках сетки
+    void calc_face_velocities(vector<double>* velocity) const
+    {
+        double S_0 = pipe.wall.getArea();
+        velocity->resize(Q.size());
+        for (size_t index = 0; index < Q.size(); ++index) {
+            (*velocity)[index] = Q[index] / S_0;
+        }
+    }
+
     /// @brief Левая часть
     /// @param index 
     /// @return 
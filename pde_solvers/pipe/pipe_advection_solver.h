@@ -69,4 +69,61 @@ protected:
 };
 
 
+/// @brief Решатель транспортного уравнения при числе Куранта, равном единице,
+/// на циклическом профиле. В отличие от advection_moc_solver не копирует слой: 
+/// шаг сводится к сдвигу начала профиля и записи граничного значения, O(1)
+/// Скорость берется из уравнения в первой точке и считается постоянной по длине трубопровода
+/// Слой один - его можно хранить в ring_buffer_t из одного слоя
+class advection_circular_solver
+{
+public:
+    /// @brief Конструктор транспортного солвера
+    /// @param pde Уравнение адвекции по объемному расходу
+    /// @param profile Рассчитываемый профиль (одновременно прошлый и новый слой)
+    advection_circular_solver(const PipeQAdvection& pde, circular_profile_t<double>& profile)
+        : pde{ pde }
+        , profile{ profile }
+    {}
+
+    /// @brief Конструктор на основе буфера из одного слоя
+    advection_circular_solver(const PipeQAdvection& pde,
+        ring_buffer_t<circular_profile_t<double>>& buffer)
+        : advection_circular_solver(pde, buffer.current())
+    {}
+
+    /// @brief Расчёт шага по времени, при котором Курант равен единице (Cr = 1)
+    double prepare_step() const
+    {
+        const std::vector<double>& grid = pde.get_grid();
+        double dx = grid[1] - grid[0];
+        return dx / std::abs(get_eigen_value());
+    }
+
+    /// @brief Расчёт нового слоя
+    /// @param par_in Значение параметра среды, втекающей в начало трубопровода
+    /// @param par_out Значение параметра среды, втекающей в конец трубопровода при обратном течении 
+    void step(double par_in, double par_out)
+    {
+        double eigen_value = get_eigen_value();
+        if (eigen_value > 0) {
+            profile.shift(+1, par_in);
+        }
+        else if (eigen_value < 0) {
+            profile.shift(-1, par_out);
+        }
+    }
+
+protected:
+    /// @brief Уравнение адвекции
+    const PipeQAdvection& pde;
+    /// @brief Рассчитываемый профиль
+    circular_profile_t<double>& profile;
+
+    /// @brief Собственное значение (скорость) в первой точке трубопровода
+    double get_eigen_value() const
+    {
+        return pde.getEquationsCoeffs(0, 0.0);
+    }
+};
+
 }
\ No newline at end of file
@@ -66,6 +66,47 @@ inline double hydraulic_resistance_isaev(double reynolds_number, double relative
     return lam;
 }
 
+/// @brief Производная гидравлического сопротивления по формуле Исаева (hydraulic_resistance_isaev) 
+/// по числу Рейнольдса. Сопротивление зависит от |Re|, поэтому производная нечетна по Re
+/// @param reynolds_number 
+/// @param relative_roughness 
+/// @return dλ/dRe
+inline double hydraulic_resistance_isaev_derivative(double reynolds_number, double relative_roughness) {
+    const double Re = fabs(reynolds_number);
+    const double& Ke = relative_roughness;
+    const double sign = reynolds_number < 0 ? -1.0 : 1.0;
+
+    double dlam;
+    if (Re < 1) {
+        dlam = 0;
+    }
+    else if (Re < 2320)
+    {
+        dlam = -64 / (Re * Re);
+    }
+    else if (Re < 4000)
+    {
+        double gm = 1 - exp(-0.002 * (Re - 2320));
+        double dgm = 0.002 * (1 - gm);
+        double laminar = 64 / Re;
+        double blasius = 0.3164 / pow(Re, 0.25);
+        dlam = -laminar / Re * (1 - gm) - 0.25 * blasius / Re * gm + (blasius - laminar) * dgm;
+    }
+    else if (Re < 560 / Ke)
+    {
+        // λ = (-1.8 lg(a))^-2, a = 6.8 / Re + (Ke / 3.7)^1.1
+        double a = 6.8 / Re + pow(Ke / 3.7, 1.1);
+        double root = -1.8 * log10(a);
+        double dlam_da = 3.6 / (a * log(10.0) * root * root * root);
+        dlam = dlam_da * (-6.8 / (Re * Re));
+    }
+    else
+    {
+        dlam = 0;
+    }
+    return sign * dlam;
+}
+
 /// @brief Стационарный расчет трубопровода по граничным давлениям для заданной системы 
 /// уравнений методом Эйлера
 /// @tparam PipeModel 
@@ -93,4 +134,317 @@ inline double solve_pipe_PP(PipeModel& model, double Pin, double Pout,
 
     return result.argument;
 }
+
+/// @brief Параметры решения задачи PP методом Ньютона (solve_pipe_PP_newton)
+struct pipe_PP_newton_parameters_t {
+    /// @brief Допустимая невязка давления на входе, Па
+    double pressure_tolerance{ 1e-2 };
+    /// @brief Ограничение на шаг по расходу
+    double flow_step_limit{ 50 };
+    /// @brief Предельное количество расчетов профиля
+    size_t iteration_count{ 50 };
+};
+
+/// @brief Результат решения задачи PP методом Ньютона
+struct pipe_PP_newton_result_t {
+    /// @brief Расход
+    double flow{ 0 };
+    /// @brief Невязка давления на входе (расчетное минус заданное), Па
+    double pressure_residual{ std::numeric_limits<double>::quiet_NaN() };
+    /// @brief Количество расчетов профиля (каждый дает и невязку, и производную)
+    size_t iteration_count{ 0 };
+    /// @brief Признак сходимости
+    bool converged{ false };
+};
+
+/// @brief Шаг Ньютона по расходу для задачи PP, ограниченный flow_step_limit
+/// При нулевом расходе трение квадратично по расходу и dPin/dG = 0 - тогда делается 
+/// предельный шаг в сторону уменьшения невязки (давление на входе растет с расходом)
+/// @param pressure_residual Невязка давления на входе
+/// @param dPin_dG Производная давления на входе по расходу
+/// @param parameters Параметры метода
+inline double calc_pipe_PP_newton_step(double pressure_residual, double dPin_dG,
+    const pipe_PP_newton_parameters_t& parameters)
+{
+    if (dPin_dG == 0) {
+        return pressure_residual > 0 ? -parameters.flow_step_limit : parameters.flow_step_limit;
+    }
+    double step = -pressure_residual / dPin_dG;
+    return std::max(-parameters.flow_step_limit, std::min(parameters.flow_step_limit, step));
+}
+
+/// @brief Стационарный расчет трубопровода по граничным давлениям методом Ньютона
+/// Производная dPin/dG считается вместе с профилем за один проход (solve_euler_corrector_sensitivity),
+/// поэтому итерация стоит одного расчета профиля. В квазистационарных расчетах начальным 
+/// приближением служит расход предыдущего шага, тогда обычно хватает 2-3 итераций
+/// @param model Модель трубы с переменными (давление, расход)
+/// @param Pin Давление на входе
+/// @param Pout Давление на выходе
+/// @param initial_flow Начальное приближение расхода
+/// @param layer Профиль давления и расхода (после расчета соответствует найденному расходу)
+/// @param parameters Параметры метода
+template <typename PipeModel>
+inline pipe_PP_newton_result_t solve_pipe_PP_newton(PipeModel& model, double Pin, double Pout,
+    double initial_flow, profile_wrapper<double, 2>* layer,
+    const pipe_PP_newton_parameters_t& parameters = pipe_PP_newton_parameters_t())
+{
+    pipe_PP_newton_result_t result;
+    result.flow = initial_flow;
+
+    while (true) {
+        array<double, 2> sensitivity = solve_euler_corrector_sensitivity<2>(
+            model, -1, { Pout, result.flow }, { 0, 1 }, layer);
+        result.iteration_count++;
+
+        result.pressure_residual = layer->profile(0).front() - Pin;
+        if (std::abs(result.pressure_residual) < parameters.pressure_tolerance) {
+            result.converged = true;
+            break;
+        }
+        double dPin_dG = sensitivity[0];
+        if (result.iteration_count == parameters.iteration_count || !std::isfinite(dPin_dG)) {
+            break; // расход остается согласованным с профилем
+        }
+        result.flow += calc_pipe_PP_newton_step(result.pressure_residual, dPin_dG, parameters);
+    }
+    return result;
+}
+
+/// @brief Геометрия трубы в точке сетки, общая для вариантов расчета на одной трубе
+/// (см. PipeModelPGConstArea::get_point_geometry, solve_pipe_PP_batch)
+struct pipe_point_geometry_t {
+    /// @brief Индекс точки сетки
+    size_t grid_index;
+    /// @brief Площадь сечения
+    double area;
+    /// @brief Величина, обратная площади сечения
+    double inverse_area;
+    /// @brief Внутренний диаметр
+    double diameter;
+    /// @brief Относительная шероховатость
+    double relative_roughness;
+};
+
+/// @brief Рабочие массивы расчета трения для многих вариантов в одной точке сетки (по массиву на величину)
+struct pipe_friction_batch_t {
+    /// @brief Скорости
+    vector<double> velocity;
+    /// @brief Числа Рейнольдса
+    vector<double> reynolds_number;
+    /// @brief Коэффициенты гидравлического сопротивления
+    vector<double> lambda;
+    /// @brief Производные коэффициентов гидравлического сопротивления по числу Рейнольдса
+    vector<double> dlambda_dRe;
+
+    void resize(size_t count) {
+        velocity.resize(count);
+        reynolds_number.resize(count);
+        lambda.resize(count);
+        dlambda_dRe.resize(count);
+    }
+};
+
+/// @brief Признак модели трубы для пакетного решения задач PP (solve_pipe_PP_batch): 
+/// геометрия точки сетки общая для вариантов (get_point_geometry), реология варианта задается
+/// плотностью и вязкостью в точке (get_density, get_point_viscosity), градиент давления и его 
+/// производная по расходу считаются сразу для массива вариантов (point_right_party_batch)
+template <typename PipeModel, typename = void>
+struct pipe_model_has_batch_right_party : std::false_type {};
+
+template <typename PipeModel>
+struct pipe_model_has_batch_right_party<PipeModel, std::void_t<
+    decltype(std::declval<const PipeModel&>().get_point_geometry(size_t())),
+    decltype(std::declval<const PipeModel&>().get_density()),
+    decltype(std::declval<const PipeModel&>().get_point_viscosity(size_t())),
+    decltype(std::declval<const PipeModel&>().point_right_party_batch(
+        std::declval<const pipe_point_geometry_t&>(), size_t(), 
+        std::declval<const double*>(), std::declval<const double*>(), 
+        std::declval<const double*>(), std::declval<const double*>(),
+        std::declval<pipe_friction_batch_t&>(), std::declval<double*>(), std::declval<double*>()))>> 
+    : std::true_type {};
+
+/// @brief Параметры пакетного решения задач PP (solve_pipe_PP_batch)
+struct pipe_PP_batch_parameters_t : pipe_PP_newton_parameters_t {
+    /// @brief Количество вариантов, которые проходят профиль одновременно
+    size_t batch_size{ 16 };
+    /// @brief Распределение вариантов по потокам (chunk_size - вариантов на порцию потока)
+    parallel_settings_t parallel;
+};
+
+/// @brief Пакетный стационарный расчет трубопровода по граничным давлениям для многих вариантов
+/// Варианты проходят профиль одновременно порциями по batch_size: на каждом шаге сетки 
+/// делается шаг Эйлера с производной dPin/dG (как в solve_euler_corrector_sensitivity) для всех 
+/// еще не сошедшихся вариантов порции. Все величины вариантов (давление, чувствительность, 
+/// плотность, вязкость в точке, число Рейнольдса, λ) хранятся в отдельных непрерывных массивах, 
+/// прогноз и коррекция считаются простыми циклами по этим массивам. Геометрия точки сетки 
+/// берется из первой модели один раз на порцию и переходит на следующий шаг вместе с вязкостями.
+/// Расход и его чувствительность вдоль трубы не меняются (правая часть для расхода нулевая).
+/// Профили давления порции пишутся по точкам сетки (для точки - подряд по вариантам) и 
+/// переписываются в pressure_profiles, когда вариант выходит из итераций.
+/// Итерации Ньютона общие для порции, сошедшиеся варианты исключаются из прохода.
+/// Результат каждого варианта совпадает с solve_pipe_PP_newton
+/// @param models Модели трубы (варианты реологии): одна на все варианты или по одной на вариант. 
+/// Все модели должны описывать одну и ту же трубу (проверяется только размер сетки), 
+/// геометрия и формула сопротивления берутся из первой модели
+/// @param Pin Давления на входе
+/// @param Pout Давления на выходе
+/// @param initial_flow Начальные приближения расхода (пустой вектор - нулевые)
+/// @param pressure_profiles Профили давления по вариантам (может отсутствовать)
+/// @param parameters Параметры метода
+/// @return Результаты по вариантам
+template <typename PipeModel>
+inline vector<pipe_PP_newton_result_t> solve_pipe_PP_batch(const vector<PipeModel*>& models,
+    const vector<double>& Pin, const vector<double>& Pout, const vector<double>& initial_flow,
+    vector<vector<double>>* pressure_profiles,
+    const pipe_PP_batch_parameters_t& parameters = pipe_PP_batch_parameters_t())
+{
+    static_assert(pipe_model_has_batch_right_party<PipeModel>::value,
+        "Pipe model must provide get_point_geometry, get_density, get_point_viscosity and point_right_party_batch");
+
+    size_t case_count = Pin.size();
+    if (Pout.size() != case_count || (!initial_flow.empty() && initial_flow.size() != case_count)) {
+        throw std::logic_error("Batch boundary conditions size mismatch");
+    }
+    if (models.size() != 1 && models.size() != case_count) {
+        throw std::logic_error("Batch models count must be 1 or equal to cases count");
+    }
+    const vector<double>& grid = models.front()->get_grid();
+    size_t point_count = grid.size();
+    for (PipeModel* model : models) {
+        if (model->get_grid().size() != point_count) {
+            throw std::logic_error("Batch models grid size mismatch");
+        }
+    }
+    if (pressure_profiles != nullptr) {
+        pressure_profiles->resize(case_count);
+        for (vector<double>& profile : *pressure_profiles) {
+            profile.resize(point_count);
+        }
+    }
+
+    vector<pipe_PP_newton_result_t> results(case_count);
+    for (size_t k = 0; k < case_count; ++k) {
+        results[k].flow = initial_flow.empty() ? 0.0 : initial_flow[k];
+    }
+
+    size_t batch_size = std::max<size_t>(parameters.batch_size, 1);
+    const PipeModel& pipe_model = *models.front();
+
+    auto solve_batch = [&](size_t case_from, size_t case_to) {
+        size_t count = case_to - case_from;
+        vector<size_t> active(count); // номера вариантов, еще не сошедшихся
+        // величины вариантов - по массиву на величину, индекс - место варианта в active
+        vector<double> pressure(count);
+        vector<double> flow(count);
+        vector<double> pressure_sensitivity(count);
+        vector<double> flow_sensitivity(count);
+        vector<double> density(count);
+        vector<double> viscosity(count);
+        vector<double> next_viscosity(count);
+        vector<double> gradient(count);
+        vector<double> gradient_derivative(count);
+        vector<double> prediction(count);
+        vector<double> prediction_sensitivity(count);
+        vector<double> next_gradient(count);
+        vector<double> next_gradient_derivative(count);
+        pipe_friction_batch_t friction;
+        friction.resize(count);
+        // профили давления порции: для точки сетки подряд по вариантам
+        vector<double> profile_block(pressure_profiles != nullptr ? point_count * count : 0);
+
+        vector<const PipeModel*> case_models(count);
+        for (size_t k = 0; k < count; ++k) {
+            case_models[k] = models.size() == 1 ? models.front() : models[case_from + k];
+            active[k] = k;
+        }
+        size_t active_count = count;
+
+        while (active_count > 0) {
+            size_t index = point_count - 1;
+            pipe_point_geometry_t geometry = pipe_model.get_point_geometry(index);
+            for (size_t a = 0; a < active_count; ++a) {
+                size_t k = active[a];
+                const PipeModel& model = *case_models[k];
+                pressure[a] = Pout[case_from + k];
+                flow[a] = results[case_from + k].flow;
+                pressure_sensitivity[a] = 0;
+                flow_sensitivity[a] = 1;
+                density[a] = model.get_density();
+                viscosity[a] = model.get_point_viscosity(index);
+            }
+            if (pressure_profiles != nullptr) {
+                std::copy(pressure.begin(), pressure.begin() + active_count, &profile_block[index * count]);
+            }
+
+            for (; index > 0; --index) {
+                size_t next_index = index - 1;
+                double dx = grid[next_index] - grid[index];
+                pipe_point_geometry_t next_geometry = pipe_model.get_point_geometry(next_index);
+                for (size_t a = 0; a < active_count; ++a) {
+                    next_viscosity[a] = case_models[active[a]]->get_point_viscosity(next_index);
+                }
+
+                // прогноз, расход прогноза равен расходу в точке
+                pipe_model.point_right_party_batch(geometry, active_count, 
+                    flow.data(), flow_sensitivity.data(), density.data(), viscosity.data(), 
+                    friction, gradient.data(), gradient_derivative.data());
+                for (size_t a = 0; a < active_count; ++a) {
+                    prediction[a] = pressure[a] + dx * gradient[a];
+                    prediction_sensitivity[a] = pressure_sensitivity[a] + dx * gradient_derivative[a];
+                }
+                // коррекция
+                pipe_model.point_right_party_batch(next_geometry, active_count,
+                    flow.data(), flow_sensitivity.data(), density.data(), next_viscosity.data(),
+                    friction, next_gradient.data(), next_gradient_derivative.data());
+                for (size_t a = 0; a < active_count; ++a) {
+                    pressure[a] = pressure[a] + dx * (0.5 * (gradient[a] + next_gradient[a]));
+                    pressure_sensitivity[a] = pressure_sensitivity[a] 
+                        + dx * (0.5 * (gradient_derivative[a] + next_gradient_derivative[a]));
+                }
+                if (pressure_profiles != nullptr) {
+                    std::copy(pressure.begin(), pressure.begin() + active_count, &profile_block[next_index * count]);
+                }
+
+                geometry = next_geometry;
+                viscosity.swap(next_viscosity);
+            }
+
+            // шаг Ньютона, сошедшиеся варианты исключаются, их профили переписываются
+            size_t still_active = 0;
+            for (size_t a = 0; a < active_count; ++a) {
+                size_t k = active[a];
+                pipe_PP_newton_result_t& result = results[case_from + k];
+                result.iteration_count++;
+                result.pressure_residual = pressure[a] - Pin[case_from + k];
+                bool finished = true;
+                if (std::abs(result.pressure_residual) < parameters.pressure_tolerance) {
+                    result.converged = true;
+                }
+                else {
+                    double dPin_dG = pressure_sensitivity[a];
+                    if (result.iteration_count != parameters.iteration_count && std::isfinite(dPin_dG)) {
+                        result.flow += calc_pipe_PP_newton_step(result.pressure_residual, dPin_dG, parameters);
+                        active[still_active++] = k;
+                        finished = false;
+                    }
+                }
+                if (finished && pressure_profiles != nullptr) {
+                    vector<double>& profile = (*pressure_profiles)[case_from + k];
+                    for (size_t point = 0; point < point_count; ++point) {
+                        profile[point] = profile_block[point * count + a];
+                    }
+                }
+            }
+            active_count = still_active;
+        }
+    };
+
+    parallel_for_chunks(parameters.parallel, 0, case_count, [&](size_t chunk_from, size_t chunk_to) {
+        for (size_t case_from = chunk_from; case_from < chunk_to; case_from += batch_size) {
+            solve_batch(case_from, std::min(case_from + batch_size, chunk_to));
+        }
+        });
+
+    return results;
+}
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ public:
     using pde_t<2>::equation_coeffs_type;
     using pde_t<2>::right_party_type;
     using pde_t<2>::var_type;
+    /// @brief Собственные числа (±c) и векторы не зависят от координаты и переменных
+    static constexpr bool has_constant_eigens = true;
 protected:
     pipe_properties_t pipe;
     oil_parameters_t oil;
@@ -79,6 +81,103 @@ public:
         return s;
     }
 
+    /// @brief Производная правой части по направлению J(u) * du по аналитическому якобиану
+    /// Источник зависит только от расхода, dλ/dRe - см. pipe_properties::get_resistance_derivative
+    virtual right_party_type ode_right_party_derivative(size_t grid_index, const var_type& point_vector,
+        const right_party_type& right_party, const var_type& direction) const override
+    {
+        return point_right_party_derivative(get_point_geometry(grid_index), point_vector, direction);
+    }
+
+    /// @brief Кинематическая вязкость в точке сетки
+    virtual double get_point_viscosity(size_t grid_index) const
+    {
+        return oil.viscosity();
+    }
+    /// @brief Плотность
+    double get_density() const
+    {
+        return oil.density();
+    }
+    /// @brief Геометрия трубы в точке сетки
+    pipe_point_geometry_t get_point_geometry(size_t grid_index) const
+    {
+        double S_0 = pipe.wall.getArea();
+        return { grid_index, S_0, 1 / S_0, pipe.wall.diameter, pipe.wall.relativeRoughness() };
+    }
+    /// @brief Правая часть по заранее полученной геометрии точки, совпадает с ode_right_party
+    right_party_type point_right_party(const pipe_point_geometry_t& geometry, const var_type& point_vector) const
+    {
+        double G = point_vector[1];
+        double rho = oil.density();
+        double S_0 = geometry.area;
+        double v = G / (rho * S_0);
+        double Re = v * geometry.diameter / get_point_viscosity(geometry.grid_index);
+        double lambda = pipe.resistance_function(Re, geometry.relative_roughness);
+        double tau_w = lambda / 8 * rho * v * abs(v);
+        double s1 = -M_PI * geometry.diameter * tau_w;
+        // A^-1 * (0, s1): давление меняется только за счет трения, расход постоянен
+        return { geometry.inverse_area * s1, 0 };
+    }
+    /// @brief Производная правой части по направлению по заранее полученной геометрии точки
+    right_party_type point_right_party_derivative(const pipe_point_geometry_t& geometry, 
+        const var_type& point_vector, const var_type& direction) const
+    {
+        double G = point_vector[1];
+        double viscosity = get_point_viscosity(geometry.grid_index);
+        double rho = oil.density();
+        double S_0 = geometry.area;
+        double d = geometry.diameter;
+        double v = G / (rho * S_0);
+        double Re = v * d / viscosity;
+        double lambda = pipe.resistance_function(Re, geometry.relative_roughness);
+        double dlambda_dRe = pipe.get_resistance_derivative(Re, geometry.relative_roughness);
+        // d(λ v|v|)/dv = dλ/dRe * dRe/dv * v|v| + 2 λ |v|
+        double dtau_dv = rho / 8 * (dlambda_dRe * d / viscosity * v * abs(v) + 2 * lambda * abs(v));
+        double ds1_dG = -M_PI * d * dtau_dv / (rho * S_0);
+        return { geometry.inverse_area * (ds1_dG * direction[1]), 0 };
+    }
+    /// @brief Градиент давления и его производная по направлению для многих вариантов реологии 
+    /// в одной точке (solve_pipe_PP_batch). Совпадает с point_right_party, point_right_party_derivative
+    /// (правая часть для расхода нулевая). Формула сопротивления считается одним вызовом на массив
+    /// @param geometry Геометрия точки
+    /// @param count Количество вариантов
+    /// @param flow Расходы
+    /// @param flow_direction Приращения расходов (направление производной)
+    /// @param density Плотности
+    /// @param viscosity Вязкости в точке
+    /// @param friction Рабочие массивы расчета трения
+    /// @param pressure_gradient Градиенты давления
+    /// @param pressure_gradient_derivative Производные градиентов давления по направлению
+    void point_right_party_batch(const pipe_point_geometry_t& geometry, size_t count,
+        const double* flow, const double* flow_direction, const double* density, const double* viscosity,
+        pipe_friction_batch_t& friction, double* pressure_gradient, double* pressure_gradient_derivative) const
+    {
+        double S_0 = geometry.area;
+        double d = geometry.diameter;
+        double* v = friction.velocity.data();
+        double* Re = friction.reynolds_number.data();
+        double* lambda = friction.lambda.data();
+        double* dlambda_dRe = friction.dlambda_dRe.data();
+        for (size_t k = 0; k < count; ++k) {
+            v[k] = flow[k] / (density[k] * S_0);
+            Re[k] = v[k] * d / viscosity[k];
+        }
+        pipe.get_resistance(Re, geometry.relative_roughness, lambda, count);
+        for (size_t k = 0; k < count; ++k) {
+            dlambda_dRe[k] = pipe.get_resistance_derivative(Re[k], geometry.relative_roughness);
+        }
+        for (size_t k = 0; k < count; ++k) {
+            double rho = density[k];
+            double tau_w = lambda[k] / 8 * rho * v[k] * abs(v[k]);
+            double s1 = -M_PI * d * tau_w;
+            pressure_gradient[k] = geometry.inverse_area * s1;
+            double dtau_dv = rho / 8 * (dlambda_dRe[k] * d / viscosity[k] * v[k] * abs(v[k]) + 2 * lambda[k] * abs(v[k]));
+            double ds1_dG = -M_PI * d * dtau_dv / (rho * S_0);
+            pressure_gradient_derivative[k] = geometry.inverse_area * (ds1_dG * flow_direction[k]);
+        }
+    }
+
     /// @brief Получение собственных чисел и соответствующих им собственных векторов
     /// \param curr
     /// \param index
@@ -330,6 +429,11 @@ public:
         var_type s = { 0, s1 };
         return s;
     }
+    /// @brief Вязкость по температуре в точке сетки (для point_right_party и производной)
+    virtual double get_point_viscosity(size_t grid_index) const override
+    {
+        return oil.viscosity(temperature[grid_index]);
+    }
 };
 
 
@@ -338,6 +442,10 @@ public:
 /// Учитывается партийность, неизотермичность
 /// В источниковый член перенесена конвекция импульса, вызванная сменой плотности
 /// Описание в документе "Уравнения для PQ"
+/// Геометрия трубы и коэффициенты сжимаемости сводятся в таблицы в конструкторе.
+/// Градиенты плотности и вязкость по профилю температуры сводятся в таблицы в update_tables(),
+/// источниковый член читает только таблицы: после изменения профилей плотности, температуры
+/// или партий (коэффициентов вязкости) нужно вызвать update_tables()
 class PipeModelPQConstAreaSortedNonisothermal : public pde_t<2>
 {
     using pde_t<2>::equation_coeffs_type;
@@ -348,9 +456,42 @@ protected:
     const pipe_properties_t& pipe;
     /// @brief Профиль свойств жидкости
     const fluid_properties_profile_t& oil;
-    /// @brief Профиль температуры
+    /// @brief Профиль температуры (читается в update_tables)
     const vector<double>& temperature;
 
+    /// @brief Площадь сечения
+    double area;
+    /// @brief Площадь сечения, умноженная на сумму коэффициентов сжимаемости трубы и жидкости
+    double area_compression;
+    /// @brief Диаметр с учетом адаптации
+    double adapted_diameter;
+    /// @brief Площадь сечения с учетом адаптации диаметра
+    double adapted_area;
+    /// @brief Относительная шероховатость
+    double relative_roughness;
+    /// @brief Уклон dz/dx в точках сетки
+    vector<double> height_gradient;
+    /// @brief Градиент плотности d(rho)/dx в точках сетки
+    vector<double> density_gradient;
+    /// @brief Вязкость в точках сетки
+    vector<double> viscosity;
+    /// @brief Пакетный расчет вязкости (пересчитывает только точки, где сменилась температура или партия)
+    viscosity_profile_evaluator_t viscosity_evaluator;
+
+    /// @brief Производная профиля в точке сетки (на концах - односторонняя разность, внутри - центральная)
+    static double calc_profile_gradient(const vector<double>& profile, const vector<double>& grid, size_t index)
+    {
+        if (index == 0) {
+            return (profile[1] - profile[0]) / (grid[1] - grid[0]);
+        }
+        else if (index == grid.size() - 1) {
+            return (profile[index] - profile[index - 1]) / (grid[index] - grid[index - 1]);
+        }
+        else {
+            return (profile[index + 1] - profile[index - 1]) / (grid[index + 1] - grid[index - 1]);
+        }
+    }
+
 public:
     PipeModelPQConstAreaSortedNonisothermal(
         const pipe_properties_t& pipe, const fluid_properties_profile_t& oil, 
@@ -359,6 +500,32 @@ public:
         , oil(oil)
         , temperature(temperature)
     {
+        area = pipe.wall.getArea();
+        area_compression = area * (pipe.wall.getCompressionRatio() + oil.get_compression_ratio());
+
+        double da = pipe.adaptation.diameter;
+        adapted_diameter = pipe.wall.diameter * da;
+        adapted_area = area * (da * da);
+        relative_roughness = pipe.wall.relativeRoughness();
+
+        const vector<double>& grid = get_grid();
+        height_gradient.resize(grid.size());
+        for (size_t index = 0; index < grid.size(); ++index) {
+            height_gradient[index] = calc_profile_gradient(pipe.profile.heights, grid, index);
+        }
+        update_tables();
+    }
+
+    /// @brief Пересчет таблиц по текущим профилям плотности, температуры и коэффициентов вязкости
+    /// Градиенты плотности пересчитываются целиком, вязкость - только в точках, 
+    /// где сменилась температура или партия (см. viscosity_profile_evaluator_t)
+    void update_tables() {
+        const vector<double>& grid = get_grid();
+        density_gradient.resize(grid.size());
+        for (size_t index = 0; index < grid.size(); ++index) {
+            density_gradient[index] = calc_profile_gradient(oil.nominal_density, grid, index);
+        }
+        oil.get_viscosity_profile(temperature, &viscosity_evaluator, &viscosity);
     }
 
     /// @brief Возвращает известную уравнению сетку
@@ -373,15 +540,11 @@ public:
     virtual equation_coeffs_type getEquationsCoeffs(
         size_t grid_index, const var_type& point_vector) const override
     {
-        double S_0 = pipe.wall.getArea();
         double density = oil.nominal_density[grid_index];
 
-        double beta_S = pipe.wall.getCompressionRatio();
-        double beta_rho = oil.get_compression_ratio();
-
         equation_coeffs_type A; // Row-major матрица, массив вектор-строк
-        A[0] = { 0, 1 / (S_0 * (beta_S + beta_rho)) };
-        A[1] = { S_0 / density, 0 };
+        A[0] = { 0, 1 / area_compression };
+        A[1] = { area / density, 0 };
         return A;
     }
     /// @brief Обратная матрица коэффициентов системы уравнений
@@ -391,15 +554,11 @@ public:
     virtual equation_coeffs_type getEquationsCoeffsInv(
         size_t grid_index, const var_type& point_vector) const override
     {
-        double S_0 = pipe.wall.getArea();
         double density = oil.nominal_density[grid_index];
 
-        double beta_S = pipe.wall.getCompressionRatio();
-        double beta_rho = oil.get_compression_ratio();
-
         array<array<double, 2>, 2> Ainv;
-        Ainv[0] = { 0, density / S_0 };
-        Ainv[1] = { S_0 * (beta_S + beta_rho), 0 };
+        Ainv[0] = { 0, density / area };
+        Ainv[1] = { area_compression, 0 };
 
         return Ainv;
     }
@@ -409,50 +568,51 @@ public:
     /// @brief Получение вектора правой части системы уравнений
     virtual var_type getSourceTerm(size_t grid_index, const var_type& point_vector) const override
     {
-        double p = point_vector[0];
         double Q = point_vector[1];
         double rho = oil.nominal_density[grid_index];
 
-        double d = pipe.wall.diameter;
-        double S_0 = pipe.wall.getArea();
-        double da = pipe.adaptation.diameter;
-        d *= da;
-        S_0 *= da * da; // квадрат
-
+        double d = adapted_diameter;
+        double S_0 = adapted_area;
         double v = Q / S_0;
 
-        double T = temperature[grid_index];
-        double Re = v * d / oil.get_viscosity(grid_index, T);
-        double lambda = pipe.resistance_function(Re, pipe.wall.relativeRoughness());
+        double Re = v * d / viscosity[grid_index];
+        double lambda = pipe.resistance_function(Re, relative_roughness);
         lambda *= pipe.adaptation.friction;
         double tau_w = lambda / 8 * rho * v * abs(v);
 
-        double height_gradient; // dz/dx
-        double density_gradient; // d(\rho)/dx
-        const double* density_profile = &oil.nominal_density[grid_index];
-        const double* height_profile = &pipe.profile.heights[grid_index];
-        const double* grid = &(get_grid()[grid_index]);
-        if (grid_index == 0) {
-            density_gradient = (density_profile[+1] - density_profile[0]) / (grid[+1] - grid[0]);
-            height_gradient = (height_profile[+1] - height_profile[0]) / (grid[+1] - grid[0]);
-        }
-        else if (grid_index == pipe.profile.getPointCount() - 1) {
-            density_gradient = (density_profile[0] - density_profile[-1]) / (grid[0] - grid[-1]);
-            height_gradient = (height_profile[0] - height_profile[-1]) / (grid[0] - grid[-1]);
-        }
-        else {
-            density_gradient = (density_profile[+1] - density_profile[-1]) / (grid[+1] - grid[-1]);
-            height_gradient = (height_profile[+1] - height_profile[-1]) / (grid[+1] - grid[-1]);
-        }
-
         double s1 =
-            2 * S_0 * v * abs(v) / rho * density_gradient
+            2 * S_0 * v * abs(v) / rho * density_gradient[grid_index]
             - M_PI * d * tau_w / rho
-            - M_G * S_0 * height_gradient;
+            - M_G * S_0 * height_gradient[grid_index];
 
         var_type s = { 0, s1 };
         return s;
     }
+    /// @brief Производная правой части по направлению J(u) * du по аналитическому якобиану
+    /// Источник зависит только от расхода, dλ/dRe - см. pipe_properties::get_resistance_derivative
+    virtual right_party_type ode_right_party_derivative(size_t grid_index, const var_type& point_vector,
+        const right_party_type& right_party, const var_type& direction) const override
+    {
+        double Q = point_vector[1];
+        double rho = oil.nominal_density[grid_index];
+
+        double d = adapted_diameter;
+        double S_0 = adapted_area;
+        double v = Q / S_0;
+        double dRe_dv = d / viscosity[grid_index];
+
+        double Re = v * dRe_dv;
+        double lambda = pipe.resistance_function(Re, relative_roughness) * pipe.adaptation.friction;
+        double dlambda_dRe = pipe.get_resistance_derivative(Re, relative_roughness) * pipe.adaptation.friction;
+        // d(v|v|)/dv = 2|v|, d(λ v|v|)/dv = dλ/dRe * dRe/dv * v|v| + 2 λ |v|
+        double dtau_dv = rho / 8 * (dlambda_dRe * dRe_dv * v * abs(v) + 2 * lambda * abs(v));
+        double ds1_dv =
+            4 * S_0 * abs(v) / rho * density_gradient[grid_index]
+            - M_PI * d * dtau_dv / rho;
+
+        var_type source_derivative = { 0, ds1_dv / S_0 * direction[1] };
+        return getEquationsCoeffsInv(grid_index, point_vector) * source_derivative;
+    }
     virtual std::pair<var_type, equation_coeffs_type> GetLeftEigens(
         size_t index, const var_type& u) const {
         throw std::logic_error("not impl");
@@ -168,6 +168,35 @@ struct pipe_properties
     AdaptationParameters adaptation;
     /// @brief Формула расчета гидравлического сопротивления
     double(*resistance_function)(double, double) { hydraulic_resistance_isaev };
+    /// @brief Производная resistance_function по числу Рейнольдса (аналитические якобианы моделей трубы)
+    /// Подходит и для табличной формулы Исаева. Для других формул нужно задать свою производную
+    /// или nullptr - тогда производная считается численно (см. get_resistance_derivative)
+    double(*resistance_derivative_function)(double, double) { hydraulic_resistance_isaev_derivative };
+
+    /// @brief Производная гидравлического сопротивления по числу Рейнольдса
+    double get_resistance_derivative(double reynolds_number, double relative_roughness) const
+    {
+        if (resistance_derivative_function != nullptr) {
+            return resistance_derivative_function(reynolds_number, relative_roughness);
+        }
+        double h = 1e-6 * std::max(1.0, std::abs(reynolds_number));
+        return (resistance_function(reynolds_number + h, relative_roughness)
+            - resistance_function(reynolds_number - h, relative_roughness)) / (2 * h);
+    }
+    /// @brief Гидравлическое сопротивление для массива чисел Рейнольдса
+    /// Для табличной формулы Исаева таблица ищется один раз на массив, результат совпадает с resistance_function
+    void get_resistance(const double* reynolds_number, double relative_roughness,
+        double* lambda, size_t count) const
+    {
+        double(*tabulated)(double, double) = hydraulic_resistance_isaev_tabulated;
+        if (resistance_function == tabulated) {
+            hydraulic_resistance_isaev_tabulated(reynolds_number, relative_roughness, lambda, count);
+            return;
+        }
+        for (size_t index = 0; index < count; ++index) {
+            lambda[index] = resistance_function(reynolds_number[index], relative_roughness);
+        }
+    }
 
     /// @brief Скорость звука в жидкости, м^2/с
     /// TODO: указать источник литературы
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <optional>
+
 namespace pde_solvers {
 
 //using std::array;
@@ -133,23 +135,28 @@ struct moc_layer_wrapper : layer_wrapper<Dimension> {
 
 /// @brief Расчетчик метода характеристик
 /// @tparam Dimension Размерность задачи
-template <size_t Dimension>
+/// @tparam Pde Тип уравнения. По умолчанию - абстрактный pde_t (виртуальные вызовы).
+/// Если задать конкретный тип модели, вызовы уравнения в горячих циклах 
+/// будут статическими (см. pde_dispatch_t)
+template <size_t Dimension, typename Pde = pde_t<Dimension>>
 class moc_solver;
 
 
 /// @brief Расчетчик метода характеристик
 /// @tparam Dimension Размерность задачи
-template <>
-class moc_solver<1>
+template <typename Pde>
+class moc_solver<1, Pde>
 {
 public:
     typedef typename moc_task_traits<1>::specific_layer specific_layer;
+    /// @brief Вызовы уравнения со статической или виртуальной диспетчеризацией
+    typedef pde_dispatch_t<Pde> pde_call;
     //typedef typename fixed_system_types<1>::matrix_type matrix_type;
     //typedef typename fixed_system_types<1>::var_type vector_type;
 
 protected:
     /// @brief ДУЧП
-    pde_t<1>& pde;
+    Pde& pde;
     /// @brief Сетка, полученная от ДУЧП
     const vector<double>& grid;
     /// @brief Количество точек сетки
@@ -162,12 +169,15 @@ protected:
     vector<double>& eigenvals;
 
 public:
+    /// @brief Настройки многопоточного расчета (по умолчанию последовательный)
+    parallel_settings_t parallel;
+
     /// @brief Базовый конструктор, наиболее детальный
     /// @param pde ДУЧП
     /// @param prev Предыдуший слой
     /// @param curr Новый слой
     /// @param eigenvals Буфер для расчета собственных чисел (рекомендуется относить к прошлому слою)
-    moc_solver(pde_t<1>& pde,
+    moc_solver(Pde& pde,
         vector<double>& prev,
         vector<double>& curr,
         vector<double>& eigenvals
@@ -178,29 +188,39 @@ public:
         , prev(prev)
         , curr(curr)
         , eigenvals(eigenvals)
-    { }
+    { 
+        pde_call::check_dynamic_type(pde);
+    }
     /// @brief Конструктор на основе слове представленных через MOC-обертку
-    moc_solver(pde_t<1>& pde,
-        moc_layer_wrapper<1>& prev,
-        moc_layer_wrapper<1>& curr)
+    /// Обертка хранит ссылки на профили, поэтому может быть временной
+    moc_solver(Pde& pde,
+        const moc_layer_wrapper<1>& prev,
+        const moc_layer_wrapper<1>& curr)
         : moc_solver(pde, prev.values, curr.values, prev.eigenval)
     { }
     /// @brief Конструктор на основе буфера оберток 
     /// (созданного с помощью ring_buffer_t::get_custom_buffer)
-    moc_solver(pde_t<1>& pde,
+    moc_solver(Pde& pde,
         ring_buffer_t<moc_layer_wrapper<1>>& buffer)
         : moc_solver(pde, buffer[-1], buffer[0])
     { }
+    /// @brief Конструктор на основе представления буфера с MOC-обертками 
+    /// (созданного с помощью ring_buffer_t::get_buffer_view)
+    template <typename LayerType, typename Selector>
+    moc_solver(Pde& pde,
+        const ring_buffer_view_t<LayerType, Selector>& buffer)
+        : moc_solver(pde, buffer[-1], buffer[0])
+    { }
     /// @brief Конструктор, заточенный для удобства выдергивания специфического слоя, если он один в буфере
     /// Очень специфический
-    moc_solver(pde_t<1>& pde, vector<double>& prev, vector<double>& curr,
+    moc_solver(Pde& pde, vector<double>& prev, vector<double>& curr,
         std::tuple<vector<double>>& eigenvals)
         : moc_solver(pde, prev, curr, std::get<0>(eigenvals))
     { }
     /// @brief Еще один специфический конструктор, когда composite_layer_t содержит только одну задачу
-    moc_solver(pde_t<1>& pde,
-        composite_layer_t<profile_collection_t<1>, moc_solver<1>::specific_layer>& prev,
-        composite_layer_t<profile_collection_t<1>, moc_solver<1>::specific_layer>& curr)
+    moc_solver(Pde& pde,
+        composite_layer_t<profile_collection_t<1>, specific_layer>& prev,
+        composite_layer_t<profile_collection_t<1>, specific_layer>& curr)
         : moc_solver(pde, prev.vars.point_double[0], curr.vars.point_double[0], prev.specific)
     {
 
@@ -215,12 +235,16 @@ public:
     double prepare_step(double time_step = std::numeric_limits<double>::quiet_NaN()) {
         auto& values = prev;
 
-        double max_egenval = 0;
-        for (size_t grid_index = 0; grid_index < grid.size(); ++grid_index) {
-            double eigen_value = eigenvals[grid_index] = pde.getEquationsCoeffs(grid_index, values[grid_index]);
+        double max_egenval = parallel_max_chunks(parallel, 0, grid.size(), 
+            [&](size_t index_from, size_t index_to) {
+                double max_egenval = 0;
+                for (size_t grid_index = index_from; grid_index < index_to; ++grid_index) {
+                    double eigen_value = eigenvals[grid_index] = pde_call::getEquationsCoeffs(pde, grid_index, values[grid_index]);
 
-            max_egenval = std::max(max_egenval, std::abs(eigen_value));
-        }
+                    max_egenval = std::max(max_egenval, std::abs(eigen_value));
+                }
+                return max_egenval;
+            });
 
         double dx = grid[1] - grid[0];
         double courant_step = dx / max_egenval;
@@ -273,31 +297,36 @@ public:
 
         profile_wrapper<double, 1> prev_values(this->prev); // оборачиваем только для интерполяции 
 
-        for (int index = index_from; index <= index_to; ++index)
-        {
-            double p = characteristic_interpolation_offset(
-                time_step, &eigenvals[index], &grid[index]);
-            double u_old = prev_values.interpolate(index, p);
-            double b = pde.getSourceTerm(index, u_old);
+        parallel_for_chunks(parallel, index_from, static_cast<size_t>(index_to + 1), 
+            [&](size_t chunk_from, size_t chunk_to) {
+                for (size_t index = chunk_from; index < chunk_to; ++index)
+                {
+                    double p = characteristic_interpolation_offset(
+                        time_step, &eigenvals[index], &grid[index]);
+                    double u_old = prev_values.interpolate(index, p);
+                    double b = pde_call::getSourceTerm(pde, index, u_old);
 
-            double& u_new = curr_values[index];
-            u_new = u_old - time_step * b;
-        }
+                    double& u_new = curr_values[index];
+                    u_new = u_old - time_step * b;
+                }
+            });
 
         return time_step;
     }
     /// @brief Опциональный расчет нового слоя, учитываюшего граничные условия, 
     /// в зависимости от наклона характеристик
-    void step_optional_boundaries(
+    /// @return Фактический шаг по времени (см. prepare_step)
+    double step_optional_boundaries(
         double time_step, double left_value, double right_value)
     {
-        step_inner(time_step);
+        time_step = step_inner(time_step);
         if (eigenvals[0] > 0) {
             curr[0] = left_value;
         }
         if (eigenvals[n - 1] < 0) {
             curr[n - 1] = right_value;
         }
+        return time_step;
     }
     /// @brief Расчет внутренних точек нового слоя методом второго порядка
     /// Учитывает, что конфигураций характеристики могут позволить рассчитать граничные точки
@@ -313,59 +342,63 @@ public:
 
         double dl = grid[1] - grid[0];
 
-        for (int grid_index = 0; grid_index < grid.size(); ++grid_index)
-        {
-            const double& eigenval = eigenvals[grid_index];
-            if (grid_index == 0 && eigenval > 0) {
-                // надо брать точку с координатой i = -1
-                continue;
-            }
-            if (grid_index == grid.size() - 1 && eigenval < 0) {
-                continue;
-            }
-
-            double p = characteristic_interpolation_offset(time_step, &eigenval, &grid[grid_index]);
-
-            // предиктор
-            double u_old;
-            double rp1;
-            double absp = abs(p);
-            if (absp < eps || abs(1.0 - absp) < eps) {
-                // характеристика точно между двумя точками: либо косая, либо вертикальная
-                size_t index = static_cast<size_t>(grid_index + p + 0.5);
-                u_old = prev[index];
-                rp1 = pde.getSourceTerm(index, u_old);
-            }
-            else {
-                // интерполяция правой части
-                size_t grida = static_cast<size_t>(grid_index + sgn(p));
-                size_t gridb = grid_index;
-                double rp1a = pde.getSourceTerm(grida, prev_values[grida]);
-                double rp1b = pde.getSourceTerm(gridb, prev_values[gridb]);
-                rp1 = rp1a * absp + rp1b * (1 - absp); // проверка: если p = 0, то берем b(grid_index)
-                u_old = prev_values.interpolate(grid_index, p);
-            }
-
-            double u_estimate = u_old + time_step * rp1;
-
-            // корректор
-            double rp2 = pde.getSourceTerm(grid_index, u_estimate);
-            curr[grid_index] = u_old + time_step * 0.5 * (rp1 + rp2);
-
-            if (!isfinite(rp1) || !isfinite(rp2) || !isfinite(u_estimate) || !isfinite(u_old)) {
-                throw std::logic_error("infinite value");
-            }
-
-        }
+        parallel_for_chunks(parallel, 0, grid.size(), 
+            [&](size_t chunk_from, size_t chunk_to) {
+                for (int grid_index = static_cast<int>(chunk_from); grid_index < static_cast<int>(chunk_to); ++grid_index)
+                {
+                    const double& eigenval = eigenvals[grid_index];
+                    if (grid_index == 0 && eigenval > 0) {
+                        // надо брать точку с координатой i = -1
+                        continue;
+                    }
+                    if (grid_index == grid.size() - 1 && eigenval < 0) {
+                        continue;
+                    }
+
+                    double p = characteristic_interpolation_offset(time_step, &eigenval, &grid[grid_index]);
+
+                    // предиктор
+                    double u_old;
+                    double rp1;
+                    double absp = abs(p);
+                    if (absp < eps || abs(1.0 - absp) < eps) {
+                        // характеристика точно между двумя точками: либо косая, либо вертикальная
+                        size_t index = static_cast<size_t>(grid_index + p + 0.5);
+                        u_old = prev[index];
+                        rp1 = pde_call::getSourceTerm(pde, index, u_old);
+                    }
+                    else {
+                        // интерполяция правой части
+                        size_t grida = static_cast<size_t>(grid_index + sgn(p));
+                        size_t gridb = grid_index;
+                        double rp1a = pde_call::getSourceTerm(pde, grida, prev_values[grida]);
+                        double rp1b = pde_call::getSourceTerm(pde, gridb, prev_values[gridb]);
+                        rp1 = rp1a * absp + rp1b * (1 - absp); // проверка: если p = 0, то берем b(grid_index)
+                        u_old = prev_values.interpolate(grid_index, p);
+                    }
+
+                    double u_estimate = u_old + time_step * rp1;
+
+                    // корректор
+                    double rp2 = pde_call::getSourceTerm(pde, grid_index, u_estimate);
+                    curr[grid_index] = u_old + time_step * 0.5 * (rp1 + rp2);
+
+                    if (!isfinite(rp1) || !isfinite(rp2) || !isfinite(u_estimate) || !isfinite(u_old)) {
+                        throw std::logic_error("infinite value");
+                    }
+
+                }
+            });
 
         return time_step;
     }
     /// @brief Опциональный расчет граничных условий, в зависимости от наклона характеристик
     /// Метод второго порядка
-    void step2_optional_boundaries(double time_step,
+    /// @return Фактический шаг по времени (см. prepare_step)
+    double step2_optional_boundaries(double time_step,
         double left_value, double right_value)
     {
-        step2_inner(time_step);
+        time_step = step2_inner(time_step);
 
         if (eigenvals[0] > 0) {
             curr[0] = left_value;
@@ -373,28 +406,174 @@ public:
         if (eigenvals[n - 1] < 0) {
             curr[n - 1] = right_value;
         }
+        return time_step;
+    }
+
+    /// @brief Многошаговый расчет с опциональными граничными условиями (см. step_optional_boundaries)
+    /// Сдвигает буфер сам, солверы создаются один раз на все шаги (см. multistep_runner_t)
+    /// @param pde ДУЧП
+    /// @param buffer Буфер слоев, текущий слой - начальные условия
+    /// @param step_count Количество шагов
+    /// @param time_step Желаемый шаг (nan - шаг по Куранту)
+    /// @param boundaries Граничные условия на шаге boundaries(step_index) -> пара (левое, правое)
+    /// @param observer Наблюдатель observer(step_index, time_step, buffer.current())
+    /// @return Суммарное время расчета
+    template <typename BoundaryProvider, typename Observer = no_step_observer_t>
+    static double run(Pde& pde,
+        ring_buffer_t<composite_layer_t<profile_collection_t<1>, specific_layer>>& buffer,
+        size_t step_count, double time_step,
+        BoundaryProvider&& boundaries, Observer&& observer = Observer())
+    {
+        typedef composite_layer_t<profile_collection_t<1>, specific_layer> layer_type;
+        multistep_runner_t<moc_solver, layer_type> runner(buffer,
+            [&](layer_type& prev, layer_type& curr) { return moc_solver(pde, prev, curr); });
+
+        return runner.run(step_count,
+            [&](moc_solver& solver, size_t step_index) {
+                std::pair<double, double> values = boundaries(step_index);
+                return solver.step_optional_boundaries(time_step, values.first, values.second);
+            },
+            observer);
     }
 };
 
-/// @brief Расчетчик метода характеристик
+/// @brief Замороженная (постоянная по координате и времени) собственная система 
+/// уравнения для метода характеристик
+/// Считается один раз, после чего солвер не делает проход по сетке для расчета собственных 
+/// чисел/векторов на каждом шаге и не требует для них специфического слоя.
+/// Смещения характеристик для каждой точки кэшируются и пересчитываются только при смене шага
 /// @tparam Dimension Размерность задачи
 template <size_t Dimension>
+struct moc_frozen_eigens_t {
+    typedef typename fixed_system_types<Dimension>::matrix_type matrix_type;
+    typedef typename fixed_system_types<Dimension>::var_type vector_type;
+
+    /// @brief Собственные числа
+    vector_type eigenvals;
+    /// @brief Левые собственные векторы
+    matrix_type eigenvecs;
+    /// @brief Шаг по Куранту (Cr = 1 для наибольшего по модулю собственного числа)
+    double courant_step;
+    /// @brief Шаг по времени, для которого рассчитаны смещения offsets
+    double time_step{ std::numeric_limits<double>::quiet_NaN() };
+    /// @brief Смещения характеристик по каждому собственному числу для каждой точки сетки
+    /// (NaN, если характеристика выходит за пределы сетки)
+    array<vector<double>, Dimension> offsets;
+    /// @brief Веса линейной интерполяции в форме u[i + shift] * (1 - w) + u[i + shift + 1] * w
+    /// (см. _interpolate) для каждого собственного числа и каждой точки сетки
+    array<vector<double>, Dimension> weights;
+    /// @brief Сдвиг левой точки интерполяции shift относительно рассчитываемой точки
+    /// Собственные числа постоянны, поэтому сдвиг одинаков для всех точек
+    array<int, Dimension> interpolation_shift;
+    /// @brief Матрица, обратная к матрице левых собственных векторов (только для Dimension = 2)
+    matrix_type eigenvecs_inverse;
+
+    /// @brief Расчет собственной системы по первой точке сетки
+    /// @tparam Pde Тип уравнения. Если это конкретная модель, она должна объявлять 
+    /// has_constant_eigens = true. Для абстрактного pde_t постоянство гарантирует вызывающий
+    /// @param pde Уравнение
+    /// @param u Значение параметров, для которого запрашивается собственная система
+    template <typename Pde>
+    moc_frozen_eigens_t(const Pde& pde, const vector_type& u = vector_type())
+    {
+        static_assert(std::is_abstract_v<Pde> || pde_has_constant_eigens<Pde>::value,
+            "PDE model does not declare constant eigensystem");
+        std::tie(eigenvals, eigenvecs) = pde.GetLeftEigens(0, u);
+
+        double max_eigenval = 0;
+        for (double eigenval : eigenvals) {
+            max_eigenval = std::max(max_eigenval, std::abs(eigenval));
+        }
+        const vector<double>& grid = pde.get_grid();
+        courant_step = (grid[1] - grid[0]) / max_eigenval;
+
+        for (size_t eigen_index = 0; eigen_index < Dimension; ++eigen_index) {
+            interpolation_shift[eigen_index] = eigenvals[eigen_index] > 0 ? -1 : 0;
+        }
+
+        if constexpr (Dimension == 2) {
+            const matrix_type& L = eigenvecs;
+            double det = L[0][0] * L[1][1] - L[0][1] * L[1][0];
+            if (det == 0) {
+                throw std::runtime_error("Degenerate eigenvectors matrix");
+            }
+            eigenvecs_inverse[0] = { L[1][1] / det, -L[0][1] / det };
+            eigenvecs_inverse[1] = { -L[1][0] / det, L[0][0] / det };
+        }
+    }
+
+    /// @brief Пересчитывает смещения характеристик, если шаг изменился
+    /// Формула совпадает с moc_solver::characteristic_interpolation_offset при равных соседних
+    /// собственных числах
+    void prepare_offsets(double dt, const vector<double>& grid)
+    {
+        if (dt == time_step && offsets[0].size() == grid.size())
+            return;
+
+        size_t n = grid.size();
+        for (size_t eigen_index = 0; eigen_index < Dimension; ++eigen_index) {
+            offsets[eigen_index].resize(n);
+            weights[eigen_index].resize(n);
+        }
+        for (size_t grid_index = 0; grid_index < n; ++grid_index) {
+            for (size_t eigen_index = 0; eigen_index < Dimension; ++eigen_index) {
+                double lambda = eigenvals[eigen_index];
+                double& p = offsets[eigen_index][grid_index];
+                if (lambda < 0) {
+                    p = grid_index + 1 < n
+                        ? -dt * lambda / (grid[grid_index + 1] - grid[grid_index])
+                        : std::numeric_limits<double>::quiet_NaN();
+                }
+                else if (lambda > 0) {
+                    p = grid_index > 0
+                        ? -dt * lambda / (grid[grid_index] - grid[grid_index - 1])
+                        : std::numeric_limits<double>::quiet_NaN();
+                }
+                else {
+                    p = 0;
+                }
+                weights[eigen_index][grid_index] = p > 0 ? p : 1 + p;
+                if (p == 0) {
+                    weights[eigen_index][grid_index] = 0;
+                }
+            }
+        }
+        time_step = dt;
+    }
+};
+
+/// @brief Расчетчик метода характеристик
+/// @tparam Dimension Размерность задачи
+/// @tparam Pde Тип уравнения (см. объявление выше)
+template <size_t Dimension, typename Pde>
 class moc_solver {
 public:
     typedef typename moc_task_traits<Dimension>::specific_layer specific_layer;
     typedef typename fixed_system_types<Dimension>::matrix_type matrix_type;
     typedef typename fixed_system_types<Dimension>::var_type vector_type;
+    /// @brief Вызовы уравнения со статической или виртуальной диспетчеризацией
+    typedef pde_dispatch_t<Pde> pde_call;
 
 //protected:
     /// @brief ДУЧП
-    pde_t<Dimension>& pde;
+    Pde& pde;
     /// @brief Сетка, полученная от ДУЧП
     const vector<double>& grid;
     /// @brief Количество точек сетки
     const size_t n;
 
-    moc_layer_wrapper<Dimension> curr;
-    moc_layer_wrapper<Dimension> prev;
+    /// @brief Рассчитываемые значения (новый слой)
+    profile_wrapper<double, Dimension> curr_values;
+    /// @brief Значения на предыдущем слое (начальные условия)
+    profile_wrapper<double, Dimension> prev_values;
+    /// @brief Собственные числа на предыдущем слое (нет в режиме замороженных коэффициентов)
+    std::optional<profile_wrapper<double, Dimension>> prev_eigenval;
+    /// @brief Левые собственные векторы на предыдущем слое (нет в режиме замороженных коэффициентов)
+    std::optional<profile_wrapper<vector_type, Dimension>> prev_eigenvec;
+    /// @brief Замороженная собственная система (nullptr, если считается на каждом шаге)
+    moc_frozen_eigens_t<Dimension>* frozen{ nullptr };
+    /// @brief Настройки многопоточного расчета (по умолчанию последовательный)
+    parallel_settings_t parallel;
 
 protected:
     /// @brief Надо очень подробно задокументировать нотацию и ограничения использования
@@ -454,20 +633,53 @@ public:
     /// @param pde Экземпляр уравнения
     /// @param prev Прошлый слой (начальные условия)
     /// @param curr Новый, рассчитываемый слой
-    moc_solver(pde_t<Dimension>& pde,
-        composite_layer_t<profile_collection_t<Dimension>, moc_solver<Dimension>::specific_layer>& prev,
-        composite_layer_t<profile_collection_t<Dimension>, moc_solver<Dimension>::specific_layer>& curr);
+    moc_solver(Pde& pde,
+        composite_layer_t<profile_collection_t<Dimension>, specific_layer>& prev,
+        composite_layer_t<profile_collection_t<Dimension>, specific_layer>& curr)
+        : pde(pde)
+        , grid(pde.get_grid())
+        , n(pde.get_grid().size())
+        , curr_values(get_profiles_pointers(curr.vars.point_double))
+        , prev_values(get_profiles_pointers(prev.vars.point_double))
+        , prev_eigenval(get_profiles_pointers(std::get<0>(prev.specific).point_double))
+        , prev_eigenvec(get_profiles_pointers(std::get<0>(prev.specific).point_vector))
+    {
+        pde_call::check_dynamic_type(pde);
+    }
 
-    moc_solver(pde_t<Dimension>& pde,
+    moc_solver(Pde& pde,
         moc_layer_wrapper<Dimension>& prev,
         moc_layer_wrapper<Dimension>& curr)
         : pde(pde)
         , grid(pde.get_grid())
         , n(pde.get_grid().size())
-        , prev(prev)
-        , curr(curr)
+        , curr_values(curr.values)
+        , prev_values(prev.values)
+        , prev_eigenval(prev.eigenval)
+        , prev_eigenvec(prev.eigenvec)
     {
+        pde_call::check_dynamic_type(pde);
+    }
 
+    /// @brief Конструктор для режима замороженных коэффициентов
+    /// Собственная система берется из frozen, специфический слой не нужен
+    /// @param pde Экземпляр уравнения
+    /// @param frozen Замороженная собственная система (живет дольше солвера, 
+    /// чтобы кэш смещений переиспользовался между шагами)
+    /// @param prev Прошлый слой (начальные условия)
+    /// @param curr Новый, рассчитываемый слой
+    moc_solver(Pde& pde,
+        moc_frozen_eigens_t<Dimension>& frozen,
+        profile_collection_t<Dimension>& prev,
+        profile_collection_t<Dimension>& curr)
+        : pde(pde)
+        , grid(pde.get_grid())
+        , n(pde.get_grid().size())
+        , curr_values(get_profiles_pointers(curr.point_double))
+        , prev_values(get_profiles_pointers(prev.point_double))
+        , frozen(&frozen)
+    {
+        pde_call::check_dynamic_type(pde);
     }
 
 public:
@@ -482,19 +694,27 @@ public:
     std::pair<vector_type, double> get_characteristic_equation(
         double time_step, size_t eigenval_index, size_t grid_index) const
     {
-        const profile_wrapper<double, Dimension>& eigenvals = prev.eigenval;
-        const profile_wrapper<vector_type, Dimension>& eigenvecs = prev.eigenvec;
-        const profile_wrapper<double, Dimension>& values = prev.values;
+        const profile_wrapper<double, Dimension>& values = prev_values;
 
-        const double* eigenval = &eigenvals.profile(eigenval_index)[grid_index];
-        double p = characteristic_interpolation_offset(time_step, eigenval, &grid[grid_index]);
+        vector_type li;
+        double p;
+        if (frozen != nullptr) {
+            li = frozen->eigenvecs[eigenval_index];
+            p = frozen->offsets[eigenval_index][grid_index];
+        }
+        else {
+            const profile_wrapper<double, Dimension>& eigenvals = *prev_eigenval;
+            const profile_wrapper<vector_type, Dimension>& eigenvecs = *prev_eigenvec;
 
-        vector_type li = eigenvecs.interpolate_dimension(eigenval_index, grid_index, p);
+            const double* eigenval = &eigenvals.profile(eigenval_index)[grid_index];
+            p = characteristic_interpolation_offset(time_step, eigenval, &grid[grid_index]);
+            li = eigenvecs.interpolate_dimension(eigenval_index, grid_index, p);
+        }
         vector_type u_old = values.interpolate(grid_index, p);
 
         // тут не совсем логично, grid_index не учитывает интерполяцию
         // может быть добавить туда смещение, вроде: getSourceTerm(grid_index, p, u_old); 
-        vector_type b = pde.getSourceTerm(grid_index, u_old);
+        vector_type b = pde_call::getSourceTerm(pde, grid_index, u_old);
 
         //L[eigenval_index] = li;
         double s = inner_prod(li, u_old + time_step * b);
@@ -532,13 +752,61 @@ public:
         pair<vector_type, double> eq_right =
             get_characteristic_equation(time_step, 1, grid.size() - 1);
 
-        curr.values(0) =
+        curr_values(0) =
             solve_linear_system({ eq_left.first, left_boundary.first }, { eq_left.second, left_boundary.second });
-        curr.values(n - 1) =
+        curr_values(n - 1) =
             solve_linear_system({ eq_right.first, right_boundary.first }, { eq_right.second, right_boundary.second });
         return time_step;
     }
 
+    /// @brief Многошаговый расчет (см. step). Сдвигает буфер сам, 
+    /// солверы создаются один раз на все шаги (см. multistep_runner_t)
+    /// @param pde ДУЧП
+    /// @param buffer Буфер слоев, текущий слой - начальные условия
+    /// @param step_count Количество шагов
+    /// @param time_step Желаемый шаг (nan - шаг по Куранту)
+    /// @param boundaries Граничные условия на шаге boundaries(step_index) -> пара (левое, правое)
+    /// @param observer Наблюдатель observer(step_index, time_step, buffer.current())
+    /// @return Суммарное время расчета
+    template <typename BoundaryProvider, typename Observer = no_step_observer_t>
+    static double run(Pde& pde,
+        ring_buffer_t<composite_layer_t<profile_collection_t<Dimension>, specific_layer>>& buffer,
+        size_t step_count, double time_step,
+        BoundaryProvider&& boundaries, Observer&& observer = Observer())
+    {
+        typedef composite_layer_t<profile_collection_t<Dimension>, specific_layer> layer_type;
+        multistep_runner_t<moc_solver, layer_type> runner(buffer,
+            [&](layer_type& prev, layer_type& curr) { return moc_solver(pde, prev, curr); });
+
+        return runner.run(step_count,
+            [&](moc_solver& solver, size_t step_index) {
+                const auto& [left, right] = boundaries(step_index);
+                return solver.step(left, right, time_step);
+            },
+            observer);
+    }
+
+    /// @brief Многошаговый расчет в режиме замороженных коэффициентов (см. step, moc_frozen_eigens_t)
+    /// @param frozen Замороженная собственная система
+    /// Остальные параметры - см. run для составного слоя
+    template <typename BoundaryProvider, typename Observer = no_step_observer_t>
+    static double run(Pde& pde, moc_frozen_eigens_t<Dimension>& frozen,
+        ring_buffer_t<profile_collection_t<Dimension>>& buffer,
+        size_t step_count, double time_step,
+        BoundaryProvider&& boundaries, Observer&& observer = Observer())
+    {
+        typedef profile_collection_t<Dimension> layer_type;
+        multistep_runner_t<moc_solver, layer_type> runner(buffer,
+            [&](layer_type& prev, layer_type& curr) { return moc_solver(pde, frozen, prev, curr); });
+
+        return runner.run(step_count,
+            [&](moc_solver& solver, size_t step_index) {
+                const auto& [left, right] = boundaries(step_index);
+                return solver.step(left, right, time_step);
+            },
+            observer);
+    }
+
     /// @brief Опциональный расчет граничных условий, в зависимости от наклона характеристик
     /// Реализация только для размерности 1
     /// @param time_step 
@@ -579,19 +847,32 @@ public:
     }
 
     double prepare_step(double time_step = std::numeric_limits<double>::quiet_NaN()) {
-        auto& eigenval = prev.eigenval;
-        auto& eigenvec = prev.eigenvec;
-        auto& values = prev.values;
-
-        double max_egenval = 0;
-        for (size_t grid_index = 0; grid_index < grid.size(); ++grid_index) {
-            auto [val, vec] = pde.GetLeftEigens(grid_index, values(grid_index));
-            
-            max_egenval = std::max(max_egenval, get_max_abs(val));
-            eigenval(grid_index) = val;
-            eigenvec(grid_index) = vec;
+        if (frozen != nullptr) {
+            // собственная система не меняется - только проверяем шаг и обновляем кэш смещений
+            if (std::isnan(time_step) || time_step > frozen->courant_step) {
+                time_step = frozen->courant_step;
+            }
+            frozen->prepare_offsets(time_step, grid);
+            return time_step;
         }
 
+        auto& eigenval = *prev_eigenval;
+        auto& eigenvec = *prev_eigenvec;
+        auto& values = prev_values;
+
+        double max_egenval = parallel_max_chunks(parallel, 0, grid.size(),
+            [&](size_t index_from, size_t index_to) {
+                double max_egenval = 0;
+                for (size_t grid_index = index_from; grid_index < index_to; ++grid_index) {
+                    auto [val, vec] = pde_call::GetLeftEigens(pde, grid_index, values(grid_index));
+
+                    max_egenval = std::max(max_egenval, get_max_abs(val));
+                    eigenval(grid_index) = val;
+                    eigenvec(grid_index) = vec;
+                }
+                return max_egenval;
+            });
+
         double dx = grid[1] - grid[0];
         double courant_step = dx / max_egenval;
         if (std::isnan(time_step) || time_step > courant_step) {
@@ -608,29 +889,90 @@ public:
     {
         time_step = prepare_step(time_step);
 
-        auto& eigenval = prev.eigenval;
-        auto& eigenvec = prev.eigenvec;
-        auto& values = prev.values;
-
+        if constexpr (Dimension == 2) {
+            if (frozen != nullptr) {
+                step_inner_frozen_2x2(time_step);
+                return time_step;
+            }
+        }
 
         int index_from = 1;
         int index_to = static_cast<int>(grid.size() - 2);
 
-        auto& curr_values = curr.values;
+        parallel_for_chunks(parallel, index_from, static_cast<size_t>(index_to + 1),
+            [&](size_t chunk_from, size_t chunk_to) {
+                for (size_t index = chunk_from; index < chunk_to; ++index)
+                {
+                    // li * u_new = li * (u_old - dt*b) [обозначим si = li * (u_old - dt*b)]
+                    // L * u_new = S
+                    auto [L, S] = get_characteristic_equations(time_step, index);
 
-        for (int index = index_from; index <= index_to; ++index)
-        {
-            // li * u_new = li * (u_old - dt*b) [обозначим si = li * (u_old - dt*b)]
-            // L * u_new = S
-            auto [L, S] = get_characteristic_equations(time_step, index);
-            
-            curr_values(index) = solve_linear_system(L, S);
-            
-        }
+                    curr_values(index) = solve_linear_system(L, S);
+                }
+            });
 
         return time_step;
     }
 
+    /// @brief Расчет внутренних точек для системы 2x2 с замороженной собственной системой
+    /// Работает напрямую с профилями переменных (SoA) без оберток и проверок границ.
+    /// Точки обрабатываются блоками: интерполяция и решение 2x2 по готовой обратной матрице
+    /// собственных векторов - отдельные проходы без ветвлений, которые компилятор векторизует;
+    /// правая часть считается отдельным проходом со статической диспетчеризацией
+    /// \param time_step Шаг по времени (смещения в frozen уже подготовлены под него)
+    void step_inner_frozen_2x2(double time_step)
+    {
+        const double* u0 = prev_values.profile(0).data();
+        const double* u1 = prev_values.profile(1).data();
+        double* v0 = curr_values.profile(0).data();
+        double* v1 = curr_values.profile(1).data();
+
+        const matrix_type& L = frozen->eigenvecs;
+        const matrix_type& Linv = frozen->eigenvecs_inverse;
+        const double* w0 = frozen->weights[0].data();
+        const double* w1 = frozen->weights[1].data();
+        const ptrdiff_t shift0 = frozen->interpolation_shift[0];
+        const ptrdiff_t shift1 = frozen->interpolation_shift[1];
+
+        parallel_for_chunks(parallel, 1, n - 1, [&](size_t chunk_from, size_t chunk_to) {
+            constexpr size_t block_size = 256;
+            // значения на характеристиках 0 (a) и 1 (b)
+            double a0[block_size], a1[block_size], b0[block_size], b1[block_size];
+
+            for (size_t block_from = chunk_from; block_from < chunk_to; block_from += block_size) {
+                size_t count = std::min(block_size, chunk_to - block_from);
+
+                for (size_t k = 0; k < count; ++k) {
+                    ptrdiff_t i = static_cast<ptrdiff_t>(block_from + k);
+                    double wa = w0[i];
+                    double wb = w1[i];
+                    a0[k] = u0[i + shift0] * (1 - wa) + u0[i + shift0 + 1] * wa;
+                    a1[k] = u1[i + shift0] * (1 - wa) + u1[i + shift0 + 1] * wa;
+                    b0[k] = u0[i + shift1] * (1 - wb) + u0[i + shift1 + 1] * wb;
+                    b1[k] = u1[i + shift1] * (1 - wb) + u1[i + shift1 + 1] * wb;
+                }
+
+                for (size_t k = 0; k < count; ++k) {
+                    size_t i = block_from + k;
+                    vector_type sa = pde_call::getSourceTerm(pde, i, vector_type{ a0[k], a1[k] });
+                    vector_type sb = pde_call::getSourceTerm(pde, i, vector_type{ b0[k], b1[k] });
+                    a0[k] += time_step * sa[0];
+                    a1[k] += time_step * sa[1];
+                    b0[k] += time_step * sb[0];
+                    b1[k] += time_step * sb[1];
+                }
+
+                for (size_t k = 0; k < count; ++k) {
+                    size_t i = block_from + k;
+                    double s0 = L[0][0] * a0[k] + L[0][1] * a1[k];
+                    double s1 = L[1][0] * b0[k] + L[1][1] * b1[k];
+                    v0[i] = Linv[0][0] * s0 + Linv[0][1] * s1;
+                    v1[i] = Linv[1][0] * s0 + Linv[1][1] * s1;
+                }
+            }
+            });
+    }
+
 
 };
 
@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 
 
 namespace pde_solvers {
@@ -103,4 +103,533 @@ inline void solve_euler_corrector(
 
 
 
+/// @brief Решение ОДУ методом Эйлера со схемой предиктор-корректор с одновременным расчетом 
+/// чувствительности решения к начальному условию (касательная линейная модель той же схемы)
+/// Результат в буфере совпадает с solve_euler_corrector
+/// @param ode Система ОДУ
+/// @param direction Направление расчета: +1 по ходу индексов, -1 против хода индексов
+/// @param initial_condition Начальное условие
+/// @param initial_sensitivity Производная начального условия по параметру s
+/// @param _result Буфер для записи результата
+/// @return Производная решения в конечной точке по параметру s
+template <size_t Dimension, typename ResultBuffer>
+inline typename ode_t<Dimension>::var_type solve_euler_corrector_sensitivity(
+    ode_t<Dimension>& ode,
+    int direction,
+    const typename ode_t<Dimension>::var_type& initial_condition,
+    const typename ode_t<Dimension>::var_type& initial_sensitivity,
+    ResultBuffer* _result
+)
+{
+    ResultBuffer& result = *_result;
+
+    typedef typename fixed_system_types<Dimension>::var_type vector_type;
+    const vector<double>& grid = ode.get_grid();
+
+    if (result.size() != grid.size())
+        throw std::runtime_error("Result buffer and grid size must be equal");
+
+    int start_index = direction > 0 ? 0 : static_cast<int>(grid.size()) - 1;
+    int end_index = direction < 0 ? 0 : static_cast<int>(grid.size()) - 1;
+
+    result[start_index] = initial_condition;
+    vector_type sensitivity = initial_sensitivity;
+
+    for (int index = start_index; index != end_index; index += direction) {
+        int next_index = index + direction;
+
+        vector_type u_prev = result[index];
+        double dx = grid[next_index] - grid[index];
+
+        // Predictor
+        vector_type predictor_gradient = ode.ode_right_party(index, u_prev);
+        vector_type prediction = u_prev + dx * predictor_gradient;
+        vector_type predictor_sensitivity_gradient =
+            ode.ode_right_party_derivative(index, u_prev, predictor_gradient, sensitivity);
+        vector_type prediction_sensitivity = sensitivity + dx * predictor_sensitivity_gradient;
+
+        // Corrector
+        vector_type next_gradient = ode.ode_right_party(next_index, prediction);
+        vector_type next_sensitivity_gradient =
+            ode.ode_right_party_derivative(next_index, prediction, next_gradient, prediction_sensitivity);
+
+        result[next_index] = u_prev + dx * (0.5 * (predictor_gradient + next_gradient));
+        sensitivity = sensitivity + dx * (0.5 * (predictor_sensitivity_gradient + next_sensitivity_gradient));
+    }
+    return sensitivity;
+}
+
+
+
+/// @brief Параметры адаптивного интегрирования ОДУ (solve_dormand_prince)
+struct ode_adaptive_parameters_t {
+    /// @brief Относительная допустимая погрешность шага
+    double relative_tolerance{ 1e-8 };
+    /// @brief Абсолютная допустимая погрешность шага (в единицах переменных)
+    double absolute_tolerance{ 1e-6 };
+    /// @brief Начальный шаг по модулю (0 - длина первой ячейки сетки)
+    double initial_step{ 0 };
+    /// @brief Наибольший шаг по модулю
+    double max_step{ std::numeric_limits<double>::infinity() };
+    /// @brief Предельное количество шагов (принятых и отброшенных)
+    size_t max_step_count{ 1000000 };
+};
+
+/// @brief Статистика адаптивного интегрирования ОДУ
+struct ode_adaptive_result_t {
+    /// @brief Количество принятых шагов
+    size_t accepted_step_count{ 0 };
+    /// @brief Количество отброшенных шагов
+    size_t rejected_step_count{ 0 };
+};
+
+/// @brief Нормированная погрешность шага (скалярный случай)
+/// @param parameters Допустимые погрешности (поля relative_tolerance, absolute_tolerance)
+template <typename Tolerance>
+inline double ode_error_norm(double error, double u_prev, double u_next, const Tolerance& parameters)
+{
+    double scale = parameters.absolute_tolerance
+        + parameters.relative_tolerance * std::max(std::abs(u_prev), std::abs(u_next));
+    return std::abs(error) / scale;
+}
+
+/// @brief Нормированная погрешность шага (векторный случай, наибольшая по компонентам)
+template <size_t Dimension, typename Tolerance>
+inline double ode_error_norm(const array<double, Dimension>& error, const array<double, Dimension>& u_prev,
+    const array<double, Dimension>& u_next, const Tolerance& parameters)
+{
+    double result = 0;
+    for (size_t component = 0; component < Dimension; ++component) {
+        result = std::max(result, ode_error_norm(error[component], u_prev[component], u_next[component], parameters));
+    }
+    return result;
+}
+
+/// @brief Компонента переменной ОДУ (скалярный случай)
+inline double& ode_component(double& value, size_t component)
+{
+    return value;
+}
+
+/// @brief Компонента переменной ОДУ (векторный случай)
+template <size_t Dimension>
+inline double& ode_component(array<double, Dimension>& value, size_t component)
+{
+    return value[component];
+}
+
+/// @brief Решение ОДУ вложенным методом Рунге-Кутты Дормана-Принса 5(4) с выбором шага
+/// Шаг не привязан к сетке: на гладких участках один шаг перекрывает много ячеек.
+/// Правая часть между точками сетки берется из ode_t::ode_right_party_at.
+/// Значения в точках сетки внутри шага восстанавливаются непрерывным продолжением 
+/// метода 4-го порядка по уже посчитанным стадиям (плотный вывод, как в dopri5 Хайрера)
+/// @param ode Система ОДУ
+/// @param direction Направление расчета: +1 по ходу индексов, -1 против хода индексов
+/// @param initial_condition Начальное условие
+/// @param _result Буфер для записи результата в точках сетки
+/// @param parameters Параметры выбора шага
+/// @return Количество принятых и отброшенных шагов
+template <size_t Dimension, typename ResultBuffer>
+inline ode_adaptive_result_t solve_dormand_prince(
+    ode_t<Dimension>& ode,
+    int direction,
+    const typename ode_t<Dimension>::var_type& initial_condition,
+    ResultBuffer* _result,
+    const ode_adaptive_parameters_t& parameters = ode_adaptive_parameters_t()
+)
+{
+    ResultBuffer& result = *_result;
+
+    typedef typename fixed_system_types<Dimension>::var_type vector_type;
+    const vector<double>& grid = ode.get_grid();
+
+    if (result.size() != grid.size())
+        throw std::runtime_error("Result buffer and grid size must be equal");
+
+    int start_index = direction > 0 ? 0 : static_cast<int>(grid.size()) - 1;
+    int end_index = direction < 0 ? 0 : static_cast<int>(grid.size()) - 1;
+
+    result[start_index] = initial_condition;
+    ode_adaptive_result_t statistics;
+    if (start_index == end_index) {
+        return statistics;
+    }
+
+    // правая часть в произвольной координате x
+    auto right_party = [&](double x, const vector_type& u) {
+        size_t cell = static_cast<size_t>(std::upper_bound(grid.begin(), grid.end(), x) - grid.begin());
+        cell = std::min(std::max<size_t>(cell, 1), grid.size() - 1) - 1;
+        double fraction = (x - grid[cell]) / (grid[cell + 1] - grid[cell]);
+        return ode.ode_right_party_at(cell, fraction, u);
+    };
+
+    // коэффициенты Дормана-Принса
+    constexpr double c2 = 1.0 / 5, c3 = 3.0 / 10, c4 = 4.0 / 5, c5 = 8.0 / 9;
+    constexpr double a21 = 1.0 / 5;
+    constexpr double a31 = 3.0 / 40, a32 = 9.0 / 40;
+    constexpr double a41 = 44.0 / 45, a42 = -56.0 / 15, a43 = 32.0 / 9;
+    constexpr double a51 = 19372.0 / 6561, a52 = -25360.0 / 2187, a53 = 64448.0 / 6561, a54 = -212.0 / 729;
+    constexpr double a61 = 9017.0 / 3168, a62 = -355.0 / 33, a63 = 46732.0 / 5247, a64 = 49.0 / 176,
+        a65 = -5103.0 / 18656;
+    constexpr double b1 = 35.0 / 384, b3 = 500.0 / 1113, b4 = 125.0 / 192, b5 = -2187.0 / 6784, b6 = 11.0 / 84;
+    // разность решений 5-го и 4-го порядков
+    constexpr double e1 = 71.0 / 57600, e3 = -71.0 / 16695, e4 = 71.0 / 1920, e5 = -17253.0 / 339200,
+        e6 = 22.0 / 525, e7 = -1.0 / 40;
+    // непрерывное продолжение
+    constexpr double d1 = -12715105075.0 / 11282082432, d3 = 87487479700.0 / 32700410799,
+        d4 = -10690763975.0 / 1880347072, d5 = 701980252875.0 / 199316789632,
+        d6 = -1453857185.0 / 822651844, d7 = 69997945.0 / 29380423;
+
+    double x = grid[start_index];
+    double x_end = grid[end_index];
+    vector_type u = initial_condition;
+    vector_type k1 = right_party(x, u);
+    double step = parameters.initial_step > 0
+        ? parameters.initial_step
+        : std::abs(grid[start_index + direction] - grid[start_index]);
+    int next_grid_index = start_index + direction;
+
+    while (next_grid_index != end_index + direction) {
+        if (statistics.accepted_step_count + statistics.rejected_step_count >= parameters.max_step_count) {
+            throw std::runtime_error("solve_dormand_prince() step count limit exceeded");
+        }
+        step = std::min(step, parameters.max_step);
+        bool last_step = step >= std::abs(x_end - x);
+        double h = direction * (last_step ? std::abs(x_end - x) : step);
+
+        vector_type k2 = right_party(x + c2 * h, u + h * (a21 * k1));
+        vector_type k3 = right_party(x + c3 * h, u + h * (a31 * k1 + a32 * k2));
+        vector_type k4 = right_party(x + c4 * h, u + h * (a41 * k1 + a42 * k2 + a43 * k3));
+        vector_type k5 = right_party(x + c5 * h, u + h * (a51 * k1 + a52 * k2 + a53 * k3 + a54 * k4));
+        vector_type k6 = right_party(x + h, u + h * (a61 * k1 + a62 * k2 + a63 * k3 + a64 * k4 + a65 * k5));
+        double x_next = last_step ? x_end : x + h;
+        vector_type u_next = u + h * (b1 * k1 + b3 * k3 + b4 * k4 + b5 * k5 + b6 * k6);
+        vector_type k7 = right_party(x_next, u_next);
+
+        vector_type error = h * (e1 * k1 + e3 * k3 + e4 * k4 + e5 * k5 + e6 * k6 + e7 * k7);
+        double error_norm = ode_error_norm(error, u, u_next, parameters);
+        if (!std::isfinite(error_norm)) {
+            error_norm = std::numeric_limits<double>::max();
+        }
+
+        double factor = error_norm == 0
+            ? 5.0
+            : std::min(5.0, std::max(0.2, 0.9 * std::pow(error_norm, -0.2)));
+        if (error_norm > 1) {
+            statistics.rejected_step_count++;
+            step = std::abs(h) * factor;
+            continue;
+        }
+        statistics.accepted_step_count++;
+
+        // плотный вывод в точках сетки, пройденных шагом
+        vector_type dense2 = u_next - u;
+        vector_type dense3 = h * k1 - dense2;
+        vector_type dense4 = dense2 - h * k7 - dense3;
+        vector_type dense5 = h * (d1 * k1 + d3 * k3 + d4 * k4 + d5 * k5 + d6 * k6 + d7 * k7);
+        while (next_grid_index != end_index + direction &&
+            (grid[next_grid_index] - x_next) * direction <= 0)
+        {
+            if (grid[next_grid_index] == x_next) {
+                result[next_grid_index] = u_next;
+            }
+            else {
+                double theta = (grid[next_grid_index] - x) / h;
+                double theta1 = 1 - theta;
+                vector_type value = u + theta * (dense2 + theta1 * (dense3 + theta * (dense4 + theta1 * dense5)));
+                result[next_grid_index] = value;
+            }
+            next_grid_index += direction;
+        }
+
+        x = x_next;
+        u = u_next;
+        k1 = k7; // FSAL: последняя стадия - производная в начале следующего шага
+        step = std::abs(h) * factor;
+    }
+    return statistics;
+}
+
+
+
+/// @brief Решение ОДУ с правой частью, не зависящей от переменных (ode_has_state_independent_right_party), 
+/// как префиксной суммы приращений по ячейкам
+/// Правые части во всех точках считаются независимо, затем суммы приращений по блокам из 
+/// settings.chunk_size ячеек, затем - последовательно смещения блоков и, снова независимо, значения внутри блоков.
+/// Блоки не зависят от числа потоков, поэтому результат побитово одинаков при любом числе потоков.
+/// От solve_euler (solve_euler_corrector) отличается только порядком сложения
+/// @param ode Система ОДУ
+/// @param direction Направление расчета: +1 по ходу индексов, -1 против хода индексов
+/// @param initial_condition Начальное условие
+/// @param _result Буфер для записи результата
+/// @param settings Настройки многопоточного расчета
+/// @param use_corrector Приращение по полусумме правых частей на концах ячейки, как в solve_euler_corrector
+template <typename Ode, typename ResultBuffer>
+inline void solve_euler_scan(
+    const Ode& ode,
+    int direction,
+    const typename Ode::var_type& initial_condition,
+    ResultBuffer* _result,
+    const parallel_settings_t& settings = parallel_settings_t(),
+    bool use_corrector = false
+)
+{
+    static_assert(ode_has_state_independent_right_party<Ode>::value,
+        "solve_euler_scan() requires right party independent of state");
+
+    ResultBuffer& result = *_result;
+
+    typedef typename Ode::var_type vector_type;
+    const vector<double>& grid = ode.get_grid();
+
+    if (result.size() != grid.size())
+        throw std::runtime_error("Result buffer and grid size must be equal");
+
+    size_t point_count = grid.size();
+    int start_index = direction > 0 ? 0 : static_cast<int>(point_count) - 1;
+    result[start_index] = initial_condition;
+    if (point_count < 2) {
+        return;
+    }
+
+    // правые части в точках сетки (в конечной точке - только для корректора, как в solve_euler)
+    vector<vector_type> gradients(point_count);
+    size_t gradient_from = !use_corrector && direction < 0 ? 1 : 0;
+    size_t gradient_to = !use_corrector && direction > 0 ? point_count - 1 : point_count;
+    parallel_for_chunks(settings, gradient_from, gradient_to, [&](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; ++index) {
+            gradients[index] = ode.ode_right_party(index, initial_condition);
+        }
+        });
+
+    // приращение на step-м шаге расчета (от точки index к точке index + direction)
+    auto get_increment = [&](size_t step) {
+        int index = start_index + direction * static_cast<int>(step);
+        int next_index = index + direction;
+        double dx = grid[next_index] - grid[index];
+        if (use_corrector) {
+            return dx * (0.5 * (gradients[index] + gradients[next_index]));
+        }
+        else {
+            return dx * gradients[index];
+        }
+    };
+
+    size_t step_count = point_count - 1;
+    size_t block_size = std::max<size_t>(settings.chunk_size, 1);
+    size_t block_count = (step_count + block_size - 1) / block_size;
+    parallel_settings_t block_settings = settings;
+    block_settings.chunk_size = 1;
+
+    // суммы приращений по блокам
+    vector<vector_type> block_offsets(block_count + 1);
+    parallel_for_chunks(block_settings, 0, block_count, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block) {
+            size_t step_from = block * block_size;
+            size_t step_to = std::min(step_from + block_size, step_count);
+            vector_type sum = get_increment(step_from);
+            for (size_t step = step_from + 1; step < step_to; ++step) {
+                sum = sum + get_increment(step);
+            }
+            block_offsets[block + 1] = sum;
+        }
+        });
+
+    // значения в начале блоков
+    block_offsets[0] = initial_condition;
+    for (size_t block = 0; block < block_count; ++block) {
+        block_offsets[block + 1] = block_offsets[block] + block_offsets[block + 1];
+    }
+
+    // значения внутри блоков
+    parallel_for_chunks(block_settings, 0, block_count, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block) {
+            size_t step_from = block * block_size;
+            size_t step_to = std::min(step_from + block_size, step_count);
+            vector_type value = block_offsets[block];
+            for (size_t step = step_from; step < step_to; ++step) {
+                value = value + get_increment(step);
+                result[start_index + direction * static_cast<int>(step + 1)] = value;
+            }
+        }
+        });
+}
+
+
+
+/// @brief Параметры решения ОДУ методом множественной стрельбы (solve_euler_corrector_multiple_shooting)
+struct ode_multiple_shooting_parameters_t {
+    /// @brief Количество участков (0 - по числу потоков)
+    size_t segment_count{ 0 };
+    /// @brief Относительная допустимая невязка на стыках участков
+    double relative_tolerance{ 1e-10 };
+    /// @brief Абсолютная допустимая невязка на стыках участков (в единицах переменных)
+    double absolute_tolerance{ 1e-8 };
+    /// @brief Предельное количество проходов по участкам
+    size_t iteration_count{ 50 };
+    /// @brief Начальные приближения на стыках брать из буфера результата (например, с предыдущего шага по времени).
+    /// Иначе начальное приближение на всех стыках - начальное условие
+    bool use_result_as_initial_guess{ false };
+};
+
+/// @brief Результат решения ОДУ методом множественной стрельбы
+struct ode_multiple_shooting_result_t {
+    /// @brief Количество проходов по участкам
+    size_t iteration_count{ 0 };
+    /// @brief Наибольшая нормированная невязка на стыках после последнего прохода
+    double defect{ 0 };
+    /// @brief Признак сходимости
+    bool converged{ false };
+};
+
+/// @brief Решение ОДУ методом Эйлера с предиктором-корректором, распараллеленное по длине профиля 
+/// методом множественной стрельбы
+/// Профиль делится на участки, которые считаются одновременно из приближений значений на стыках; 
+/// вместе со значениями считается матрица чувствительности конца участка к его началу
+/// (как в solve_euler_corrector_sensitivity, по столбцам). Приближения на стыках уточняются методом Ньютона: 
+/// система условий стыковки блочно-двухдиагональная, поэтому шаг Ньютона - последовательный проход 
+/// по стыкам v[s+1] = y[s] + J[s] * (v_new[s] - v[s]). После k проходов первые k участков точны, 
+/// так что метод сходится не более чем за segment_count проходов, на слабо нелинейных задачах - за 2-3.
+/// Чувствительность считается через ode_t::ode_right_party_derivative: у моделей с аналитическим 
+/// якобианом (модели трубы) проход стоит 2 вычисления правой части на шаг, 
+/// у разностной производной по умолчанию - еще 2 * Dimension
+/// @param ode Система ОДУ
+/// @param direction Направление расчета: +1 по ходу индексов, -1 против хода индексов
+/// @param initial_condition Начальное условие
+/// @param _result Буфер для записи результата
+/// @param settings Настройки многопоточного расчета (участки распределяются по потокам)
+/// @param parameters Параметры метода
+template <size_t Dimension, typename ResultBuffer>
+inline ode_multiple_shooting_result_t solve_euler_corrector_multiple_shooting(
+    const ode_t<Dimension>& ode,
+    int direction,
+    const typename ode_t<Dimension>::var_type& initial_condition,
+    ResultBuffer* _result,
+    const parallel_settings_t& settings = parallel_settings_t(),
+    const ode_multiple_shooting_parameters_t& parameters = ode_multiple_shooting_parameters_t()
+)
+{
+    ResultBuffer& result = *_result;
+
+    typedef typename fixed_system_types<Dimension>::var_type vector_type;
+    typedef array<vector_type, Dimension> sensitivity_type; // столбцы матрицы чувствительности
+    const vector<double>& grid = ode.get_grid();
+
+    if (result.size() != grid.size())
+        throw std::runtime_error("Result buffer and grid size must be equal");
+
+    size_t point_count = grid.size();
+    int start_index = direction > 0 ? 0 : static_cast<int>(point_count) - 1;
+    ode_multiple_shooting_result_t shooting_result;
+    if (point_count < 2) {
+        result[start_index] = initial_condition;
+        shooting_result.converged = true;
+        return shooting_result;
+    }
+
+    size_t step_count = point_count - 1;
+    size_t segment_count = parameters.segment_count > 0
+        ? parameters.segment_count
+        : static_cast<size_t>(settings.get_thread_count());
+    segment_count = std::max<size_t>(1, std::min(segment_count, step_count));
+    size_t segment_length = (step_count + segment_count - 1) / segment_count;
+    segment_count = (step_count + segment_length - 1) / segment_length;
+
+    auto get_point_index = [&](size_t step) {
+        return start_index + direction * static_cast<int>(step);
+    };
+
+    // приближения в начале участков
+    vector<vector_type> segment_start(segment_count);
+    for (size_t segment = 0; segment < segment_count; ++segment) {
+        if (segment == 0 || !parameters.use_result_as_initial_guess) {
+            segment_start[segment] = initial_condition;
+        }
+        else {
+            vector_type guess = result[get_point_index(segment * segment_length)];
+            segment_start[segment] = guess;
+        }
+    }
+
+    vector<vector_type> segment_end(segment_count);
+    vector<sensitivity_type> segment_sensitivity(segment_count);
+    parallel_settings_t segment_settings = settings;
+    segment_settings.chunk_size = 1;
+
+    auto integrate_segment = [&](size_t segment) {
+        size_t step_from = segment * segment_length;
+        size_t step_to = std::min(step_from + segment_length, step_count);
+
+        vector_type u = segment_start[segment];
+        sensitivity_type sensitivity;
+        for (size_t column = 0; column < Dimension; ++column) {
+            vector_type unit{};
+            ode_component(unit, column) = 1;
+            sensitivity[column] = unit;
+        }
+        result[get_point_index(step_from)] = u;
+
+        for (size_t step = step_from; step < step_to; ++step) {
+            int index = get_point_index(step);
+            int next_index = index + direction;
+            double dx = grid[next_index] - grid[index];
+
+            vector_type predictor_gradient = ode.ode_right_party(index, u);
+            vector_type prediction = u + dx * predictor_gradient;
+            vector_type next_gradient = ode.ode_right_party(next_index, prediction);
+
+            for (vector_type& du : sensitivity) {
+                vector_type predictor_sensitivity_gradient =
+                    ode.ode_right_party_derivative(index, u, predictor_gradient, du);
+                vector_type prediction_sensitivity = du + dx * predictor_sensitivity_gradient;
+                vector_type next_sensitivity_gradient =
+                    ode.ode_right_party_derivative(next_index, prediction, next_gradient, prediction_sensitivity);
+                du = du + dx * (0.5 * (predictor_sensitivity_gradient + next_sensitivity_gradient));
+            }
+
+            u = u + dx * (0.5 * (predictor_gradient + next_gradient));
+            if (step + 1 < step_to || segment + 1 == segment_count) {
+                result[next_index] = u; // начало следующего участка пишет сам следующий участок
+            }
+        }
+        segment_end[segment] = u;
+        segment_sensitivity[segment] = sensitivity;
+    };
+
+    while (shooting_result.iteration_count < parameters.iteration_count) {
+        parallel_for_chunks(segment_settings, 0, segment_count, [&](size_t begin, size_t end) {
+            for (size_t segment = begin; segment < end; ++segment) {
+                integrate_segment(segment);
+            }
+            });
+        shooting_result.iteration_count++;
+
+        // невязки на стыках
+        shooting_result.defect = 0;
+        for (size_t segment = 0; segment + 1 < segment_count; ++segment) {
+            vector_type defect = segment_end[segment] - segment_start[segment + 1];
+            shooting_result.defect = std::max(shooting_result.defect,
+                ode_error_norm(defect, segment_end[segment], segment_start[segment + 1], parameters));
+        }
+        if (shooting_result.defect <= 1) {
+            shooting_result.converged = true;
+            break;
+        }
+
+        // шаг Ньютона: последовательный проход по стыкам
+        vector_type start_change = 0.0 * initial_condition;
+        for (size_t segment = 0; segment + 1 < segment_count; ++segment) {
+            vector_type next_start = segment_end[segment];
+            for (size_t column = 0; column < Dimension; ++column) {
+                next_start = next_start + ode_component(start_change, column) * segment_sensitivity[segment][column];
+            }
+            start_change = next_start - segment_start[segment + 1];
+            segment_start[segment + 1] = next_start;
+        }
+    }
+    return shooting_result;
+}
+
+
+
 }
\ No newline at end of file
@@ -33,108 +33,21 @@ struct quickest_fv_solver_traits
 };
 
 /// @brief Описание типов данных для метода конечных объемов на основе QUICKEST-ULTIMATE 
-template <size_t Dimension>
+/// @tparam Scalar Тип хранения переменных (потоки всегда double)
+template <size_t Dimension, typename Scalar = double>
 struct quickest_ultimate_fv_solver_traits
 {
-    typedef profile_collection_t<0, Dimension/*переменные - ячейки*/, 0, 0, 0, 0> var_layer_data;
+    typedef profile_collection_t<0, Dimension/*переменные - ячейки*/, 0, 0, 0, 0, Scalar> var_layer_data;
     typedef profile_collection_t<Dimension /*потоки F*/, 0,
         0, 0,
         0, 0> specific_layer;
 };
 
-/// @brief Солвер на основе upstream differencing, только для размерности 1!
-/// [Leonard 1979]
-class upstream_fv_solver {
-public:
-    typedef typename upstream_fv_solver_traits<1>::var_layer_data var_layer_data;
-    typedef typename upstream_fv_solver_traits<1>::specific_layer specific_layer;
-    typedef typename fixed_system_types<1>::matrix_type matrix_type;
-    typedef typename fixed_system_types<1>::var_type vector_type;
-protected:
-    /// @brief ДУЧП
-    pde_t<1>& pde;
-    /// @brief Сетка, полученная от ДУЧП
-    const vector<double>& grid;
-    /// @brief Количество точек сетки
-    const size_t n;
-    /// @brief Предыдущий слой переменных
-    const var_layer_data& prev_vars;
-    /// @brief Новый (рассчитываемый) слой переменных
-    var_layer_data& curr_vars;
-    /// @brief Предыдущий специфический слой (сейчас не нужен! нужен ли в будущем?)
-    const specific_layer& prev_spec;
-    /// @brief Текущий специфический слой
-    specific_layer& curr_spec;
-public:
-    /// @brief Конструктор для буфера в котором простой слой:
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// Из буфера берется current() и previous()
-    /// @param pde ДУЧП
-    /// @param buffer Буфер слоев
-    upstream_fv_solver(pde_t<1>& pde,
-        ring_buffer_t<composite_layer_t<var_layer_data, specific_layer>>& buffer)
-        : upstream_fv_solver(pde, buffer.previous(), buffer.current())
-    {}
-
-    /// @brief Конструктор для простых слоев - 
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// @param pde ДУЧП
-    /// @param prev Предыдущий слой (уже рассчитанный)
-    /// @param curr Следующий (новый), для которого требуется сделать расчет
-    upstream_fv_solver(pde_t<1>& pde,
-        const composite_layer_t<var_layer_data, specific_layer>& prev,
-        composite_layer_t<var_layer_data, specific_layer>& curr)
-        : pde(pde)
-        , grid(pde.get_grid())
-        , n(pde.get_grid().size())
-        , prev_vars(prev.vars)
-        , curr_vars(curr.vars)
-        , prev_spec(std::get<0>(prev.specific))
-        , curr_spec(std::get<0>(curr.specific))
-    {
-
-    }
-    /// @brief Расчет шага
-    /// @param dt Заданный период времени
-    /// @param u_in Левое граничное условие
-    /// @param u_out Правое граничное условие
-    void step(double dt, double u_in, double u_out) {
-        auto& F = curr_spec.point_double[0]; // потоки на границах ячеек
-        const auto& U = prev_vars.cell_double[0];
-        auto& U_new = curr_vars.cell_double[0];
-
-        // Расчет потоков на границе на основе граничных условий
-        double v_in = pde.getEquationsCoeffs(0, U[0]);
-        double v_out = pde.getEquationsCoeffs(F.size() - 1, U[U.size() - 1]);
-        if (v_in >= 0) {
-            F.front() = v_in * u_in;
-        }
-        if (v_out <= 0) {
-            F.back() = v_out * u_out;
-        }
-
-
-        // Расчет потоков на границе по правилу донорской ячейки
-        for (size_t cell = 0; cell < U.size(); ++cell) {
-            double u = U[cell];
-            double v_cell = pde.getEquationsCoeffs(cell, u); // не совсем корректно, скорость в ячейке берется из скорости на ее левой границе
-            if (v_cell > 0) {
-                size_t right_point = cell + 1;
-                double v_right = pde.getEquationsCoeffs(right_point, u);
-                F[right_point] = u * v_right;
-            }
-            else {
-                size_t left_point = cell;
-                double v_left = pde.getEquationsCoeffs(left_point, u);
-                F[left_point] = u * v_left;
-            }
-        }
-
-        for (size_t cell = 0; cell < U.size(); ++cell) {
-            double dx = grid[cell + 1] - grid[cell]; // ячейки обычно одинаковой длины, но мало ли..
-            U_new[cell] = U[cell] + dt / dx * ((F[cell] - F[cell + 1]));
-        }
-    }
+/// @brief Описание типов данных для ансамбля сценариев QUICKEST-ULTIMATE
+struct quickest_ultimate_fv_ensemble_traits
+{
+    typedef ensemble_collection_t<0, 1 /*переменные - ячейки*/> var_layer_data;
+    typedef ensemble_collection_t<1 /*потоки F*/, 0> specific_layer;
 };
 
 inline double quick_border_approximation(double U_L, double U_C, double U_R)
@@ -190,237 +103,319 @@ inline double quickest_ultimate_border_approximation(double U_L, double U_C, dou
     return Uf;
 }
 
-/// @brief Солвер на основе QUICK, только для размерности 1!
-/// [Leonard 1979]
-class quick_fv_solver {
-public:
-    typedef typename quick_fv_solver_traits<1>::var_layer_data var_layer_data;
-    typedef typename quick_fv_solver_traits<1>::specific_layer specific_layer;
-    typedef typename fixed_system_types<1>::matrix_type matrix_type;
-    typedef typename fixed_system_types<1>::var_type vector_type;
-protected:
-    /// @brief ДУЧП
-    pde_t<1>& pde;
-    /// @brief Сетка, полученная от ДУЧП
-    const vector<double>& grid;
-    /// @brief Количество точек сетки
-    const size_t n;
-    /// @brief Предыдущий слой переменных
-    const var_layer_data& prev_vars;
-    /// @brief Новый (рассчитываемый) слой переменных
-    var_layer_data& curr_vars;
-    /// @brief Предыдущий специфический слой (сейчас не нужен! нужен ли в будущем?)
-    const specific_layer& prev_spec;
-    /// @brief Текущий специфический слой
-    specific_layer& curr_spec;
-public:
-    /// @brief Конструктор для буфера в котором простой слой:
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// Из буфера берется current() и previous()
-    /// @param pde ДУЧП
-    /// @param buffer Буфер слоев
-    quick_fv_solver(pde_t<1>& pde,
-        ring_buffer_t<composite_layer_t<var_layer_data, specific_layer>>& buffer)
-        : quick_fv_solver(pde, buffer.previous(), buffer.current())
-    {}
+/// @brief Ограничитель ван Леера (TVD) [van Leer 1974]
+inline double van_leer_limiter(double r)
+{
+    return (r + abs(r)) / (1 + abs(r));
+}
 
-    /// @brief Конструктор для простых слоев - 
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// @param pde ДУЧП
-    /// @param prev Предыдущий слой (уже рассчитанный)
-    /// @param curr Следующий (новый), для которого требуется сделать расчет
-    quick_fv_solver(pde_t<1>& pde,
-        const composite_layer_t<var_layer_data, specific_layer>& prev,
-        composite_layer_t<var_layer_data, specific_layer>& curr)
-        : pde(pde)
-        , grid(pde.get_grid())
-        , n(pde.get_grid().size())
-        , prev_vars(prev.vars)
-        , curr_vars(curr.vars)
-        , prev_spec(std::get<0>(prev.specific))
-        , curr_spec(std::get<0>(curr.specific))
-    {
+/// @brief Ограничитель superbee (TVD) [Roe 1985]
+inline double superbee_limiter(double r)
+{
+    return std::max({ 0.0, std::min(2 * r, 1.0), std::min(r, 2.0) });
+}
 
+/// @brief Значение на границе ячейки по схеме Лакса-Вендроффа с ограничителем потока (TVD)
+/// U_f = U_C + (1 - Cr) * phi(r) * (U_R - U_C) / 2, r = (U_C - U_L) / (U_R - U_C)
+/// При U_R = U_C поправка нулевая, ограничитель не вызывается
+template <double(*Limiter)(double)>
+inline double tvd_border_approximation(double U_L, double U_C, double U_R, double dx, double dt, double v)
+{
+    double delta = U_R - U_C;
+    if (delta == 0) {
+        return U_C;
     }
-    /// @brief Расчет шага
-    /// @param dt Заданный период времени
-    /// @param u_in Левое граничное условие
-    /// @param u_out Правое граничное условие
-    void step(double dt, double u_in, double u_out) {
-        auto& F = curr_spec.point_double[0]; // потоки на границах ячеек
-        const auto& U = prev_vars.cell_double[0];
-        auto& U_new = curr_vars.cell_double[0];
-
-        // Расчет потоков на границе на основе граничных условий
-        double v_in = pde.getEquationsCoeffs(0, U[0]);
-        double v_out = pde.getEquationsCoeffs(F.size() - 1, U[U.size() - 1]);
-        if (v_in >= 0) {
-            F.front() = v_in * u_in;
-        }
-        if (v_out <= 0) {
-            F.back() = v_out * u_out;
-        }
-
-        double v_pipe = pde.getEquationsCoeffs(0, U[0]);//не совсем корректно, скорость в ячейке берется из скорости на ее левой границе
-        // Расчет потоков на границе по правилу QUICK
-        if (v_pipe >= 0) {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t right_border = cell + 1;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quick_border_approximation(U[cell], U[cell], U[cell + 1]); // костыль U_L = U_C
-                }
-                else if (cell == U.size() - 1) {
-                    Ub = quick_border_approximation(U[cell - 1], U[cell], U[cell]); // костыль U_R = U_C
-                }
-                else {
-                    Ub = quick_border_approximation(U[cell - 1], U[cell], U[cell + 1]); // честный расчет
-                }
-                F[right_border] = Ub * Vb;
-            }
-        }
-        else {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t left_border = cell;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quick_border_approximation(U[cell + 1], U[cell], U[cell]); // костыль U_L = U_C
-                }
-                else if (cell == U.size() - 1) {
-                    Ub = quick_border_approximation(U[cell], U[cell], U[cell - 1]); // костыль U_R = U_C
-                }
-                else {
-                    Ub = quick_border_approximation(U[cell + 1], U[cell], U[cell - 1]); // честный расчет
-                }
-                F[left_border] = Ub * Vb;
-            }
+    double Cour = abs((v * dt) / dx);
+    double r = (U_C - U_L) / delta;
+    return U_C + (1 - Cour) * Limiter(r) * delta / 2;
+}
 
-        }
+/// @brief Политики аппроксимации значения на границе ячейки для fv_solver_t
+/// Аргументы face_value: U_L - ячейка против потока, U_C - донорская ячейка, 
+/// U_R - ячейка по потоку, dx - длина донорской ячейки, dt - шаг, v - скорость
+/// courant_limited - бросать исключение при Cr > 1
+/// per_face_velocity - брать скорость из уравнения на каждой границе ячейки, а не одну на всю трубу
 
-        for (size_t cell = 0; cell < U.size(); ++cell) {
-            double dx = grid[cell + 1] - grid[cell]; // ячейки обычно одинаковой длины, но мало ли..
-            U_new[cell] = U[cell] + dt / dx * ((F[cell] - F[cell + 1]));
-        }
+/// @brief Upstream differencing (донорская ячейка) [Leonard 1979]
+struct fv_upstream_face_t {
+    static constexpr bool courant_limited = false;
+    static constexpr bool per_face_velocity = true;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return U_C;
+    }
+};
 
+/// @brief QUICK [Leonard 1979]
+struct fv_quick_face_t {
+    static constexpr bool courant_limited = false;
+    static constexpr bool per_face_velocity = false;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return quick_border_approximation(U_L, U_C, U_R);
     }
 };
 
-/// @brief Солвер на основе QUICKEST, только для размерности 1!
-/// [Neumann 2011]
-class quickest_fv_solver {
-public:
-    typedef typename quickest_fv_solver_traits<1>::var_layer_data var_layer_data;
-    typedef typename quickest_fv_solver_traits<1>::specific_layer specific_layer;
-    typedef typename fixed_system_types<1>::matrix_type matrix_type;
-    typedef typename fixed_system_types<1>::var_type vector_type;
-protected:
-    /// @brief ДУЧП
-    pde_t<1>& pde;
-    /// @brief Сетка, полученная от ДУЧП
-    const vector<double>& grid;
-    /// @brief Количество точек сетки
-    const size_t n;
-    /// @brief Предыдущий слой переменных
-    const var_layer_data& prev_vars;
-    /// @brief Новый (рассчитываемый) слой переменных
-    var_layer_data& curr_vars;
-    /// @brief Предыдущий специфический слой (сейчас не нужен! нужен ли в будущем?)
-    const specific_layer& prev_spec;
-    /// @brief Текущий специфический слой
-    specific_layer& curr_spec;
-public:
-    /// @brief Конструктор для буфера в котором простой слой:
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// Из буфера берется current() и previous()
-    /// @param pde ДУЧП
-    /// @param buffer Буфер слоев
-    quickest_fv_solver(pde_t<1>& pde,
-        ring_buffer_t<composite_layer_t<var_layer_data, specific_layer>>& buffer)
-        : quickest_fv_solver(pde, buffer.previous(), buffer.current())
-    {}
+/// @brief QUICKEST [Neumann 2011]
+struct fv_quickest_face_t {
+    static constexpr bool courant_limited = false;
+    static constexpr bool per_face_velocity = false;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return quickest_border_approximation(U_L, U_C, U_R, 0, dx, dt, v);
+    }
+};
 
-    /// @brief Конструктор для простых слоев - 
-    /// когда в слое только один блок целевых переменных и один блок служебных данных
-    /// @param pde ДУЧП
-    /// @param prev Предыдущий слой (уже рассчитанный)
-    /// @param curr Следующий (новый), для которого требуется сделать расчет
-    quickest_fv_solver(pde_t<1>& pde,
-        const composite_layer_t<var_layer_data, specific_layer>& prev,
-        composite_layer_t<var_layer_data, specific_layer>& curr)
-        : pde(pde)
-        , grid(pde.get_grid())
-        , n(pde.get_grid().size())
-        , prev_vars(prev.vars)
-        , curr_vars(curr.vars)
-        , prev_spec(std::get<0>(prev.specific))
-        , curr_spec(std::get<0>(curr.specific))
+/// @brief QUICKEST-ULTIMATE [Leonard 1991]
+struct fv_quickest_ultimate_face_t {
+    static constexpr bool courant_limited = true;
+    static constexpr bool per_face_velocity = false;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return quickest_ultimate_border_approximation(U_L, U_C, U_R, 0, dx, dt, v);
+    }
+};
+
+/// @brief TVD с ограничителем ван Леера
+struct fv_van_leer_face_t {
+    static constexpr bool courant_limited = true;
+    static constexpr bool per_face_velocity = false;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return tvd_border_approximation<van_leer_limiter>(U_L, U_C, U_R, dx, dt, v);
+    }
+};
+
+/// @brief TVD с ограничителем superbee
+struct fv_superbee_face_t {
+    static constexpr bool courant_limited = true;
+    static constexpr bool per_face_velocity = false;
+    static double face_value(double U_L, double U_C, double U_R, double dx, double dt, double v) {
+        return tvd_border_approximation<superbee_limiter>(U_L, U_C, U_R, dx, dt, v);
+    }
+};
+
+/// @brief Операции над значением в ячейке для ядра fv_kernel_t
+/// Скалярное значение (double или float) переносится потоком типа double
+/// @tparam Value Тип значения в ячейке
+template <typename Value>
+struct fv_value_traits {
+    /// @brief Поток через границу ячейки
+    typedef double flux_type;
+    /// @brief Граничное условие
+    typedef double boundary_type;
+
+    /// @brief Поток через границу ячейки по политике аппроксимации
+    template <typename FaceApproximation>
+    static void face_flux(const Value& U_L, const Value& U_C, const Value& U_R,
+        double dx, double dt, double v, flux_type& F)
     {
+        F = FaceApproximation::face_value(U_L, U_C, U_R, dx, dt, v) * v;
+    }
+    /// @brief Поток через границу трубы по граничному условию или значению в крайней ячейке
+    template <typename BoundaryValue>
+    static void boundary_flux(double v, const BoundaryValue& u, flux_type& F)
+    {
+        F = v * u;
+    }
+    /// @brief Новое значение в ячейке по потокам на ее границах
+    static void update(const Value& U_C, double dt_dx, const flux_type& F_left, const flux_type& F_right,
+        Value& U_C_new)
+    {
+        U_C_new = static_cast<Value>(U_C + dt_dx * ((F_left - F_right)));
+    }
+};
 
+/// @brief Операции над набором параметров в ячейке (см. fv_multicomponent_solver_t)
+/// Все операции выполняются покомпонентно
+template <size_t Components>
+struct fv_value_traits<std::array<double, Components>> {
+    typedef std::array<double, Components> value_type;
+    typedef value_type flux_type;
+    typedef value_type boundary_type;
+
+    template <typename FaceApproximation>
+    static void face_flux(const value_type& U_L, const value_type& U_C, const value_type& U_R,
+        double dx, double dt, double v, flux_type& F)
+    {
+        for (size_t c = 0; c < Components; ++c) {
+            F[c] = FaceApproximation::face_value(U_L[c], U_C[c], U_R[c], dx, dt, v) * v;
+        }
     }
-    /// @brief Расчет шага
-    /// @param dt Заданный период времени
+    static void boundary_flux(double v, const value_type& u, flux_type& F)
+    {
+        for (size_t c = 0; c < Components; ++c) {
+            F[c] = v * u[c];
+        }
+    }
+    static void update(const value_type& U_C, double dt_dx, const flux_type& F_left, const flux_type& F_right,
+        value_type& U_C_new)
+    {
+        for (size_t c = 0; c < Components; ++c) {
+            U_C_new[c] = U_C[c] + dt_dx * ((F_left[c] - F_right[c]));
+        }
+    }
+};
+
+/// @brief Ядро шага метода конечных объемов, общее для fv_solver_t и fv_multicomponent_solver_t
+/// Уравнение не вызывается, скорости передаются солвером
+/// @tparam FaceApproximation Политика аппроксимации значения на границе ячейки (см. fv_upstream_face_t и др.)
+/// @tparam Value Тип значения в ячейке (см. fv_value_traits)
+template <typename FaceApproximation, typename Value>
+struct fv_kernel_t {
+    typedef fv_value_traits<Value> traits;
+    typedef typename traits::flux_type flux_type;
+    typedef typename traits::boundary_type boundary_type;
+
+    /// @brief Шаг с одной скоростью на всех границах ячеек за один проход по ячейкам
+    /// Поток через каждую границу ячейки считается один раз и переносится в соседнюю ячейку.
+    /// Крайние ячейки рассчитываются отдельно (недостающий сосед заменяется самой ячейкой),
+    /// поэтому циклы по внутренним ячейкам не содержат ветвлений; для каждого направления потока свой цикл
+    /// @tparam KeepFlux Сохранять ли потоки в flux
+    /// @param grid Сетка
+    /// @param dt Шаг по времени
+    /// @param v Скорость на границах ячеек
+    /// @param v_out Скорость на правой границе трубы (для вытекания при обратном потоке)
+    /// @param U Предыдущий слой, cell_count значений
+    /// @param U_new Новый слой
+    /// @param cell_count Количество ячеек
     /// @param u_in Левое граничное условие
     /// @param u_out Правое граничное условие
-    void step(double dt, double u_in, double u_out) {
-        auto& F = curr_spec.point_double[0]; // потоки на границах ячеек
-        const auto& U = prev_vars.cell_double[0];
-        auto& U_new = curr_vars.cell_double[0];
-
-        // Расчет потоков на границе на основе граничных условий
-        double v_in = pde.getEquationsCoeffs(0, U[0]);
-        double v_out = pde.getEquationsCoeffs(F.size() - 1, U[U.size() - 1]);
-        if (v_in >= 0) {
-            F.front() = v_in * u_in;
-        }
-        if (v_out <= 0) {
-            F.back() = v_out * u_out;
-        }
-
-        double v_pipe = pde.getEquationsCoeffs(0, U[0]);//не совсем корректно, скорость в ячейке берется из скорости на ее левой границе
-        // Расчет потоков на границе по правилу QUICK
-        if (v_pipe >= 0) {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t right_border = cell + 1;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quickest_border_approximation(U[cell], U[cell], U[cell + 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_L = U_C
-                }
-                else if (cell == U.size() - 1) {
-                    Ub = quickest_border_approximation(U[cell - 1], U[cell], U[cell], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_R = U_C
-                }
-                else {
-                    Ub = quickest_border_approximation(U[cell - 1], U[cell], U[cell + 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // честный расчет
+    /// @param flux Потоки на границах ячеек, cell_count + 1 значений (только при KeepFlux)
+    template <bool KeepFlux>
+    static void step_uniform_velocity(const vector<double>& grid, double dt, double v, double v_out,
+        const Value* U, Value* U_new, size_t cell_count,
+        const boundary_type& u_in, const boundary_type& u_out, flux_type* flux)
+    {
+        const size_t last = cell_count - 1;
+
+        auto store_flux = [&](size_t face, const flux_type& F) {
+            if constexpr (KeepFlux) {
+                flux[face] = F;
+            }
+        };
+        auto face_flux = [&](const Value& U_L, const Value& U_C, const Value& U_R, size_t cell, flux_type& F) {
+            traits::template face_flux<FaceApproximation>(U_L, U_C, U_R, grid[cell + 1] - grid[cell], dt, v, F);
+        };
+        auto update_cell = [&](size_t cell, const flux_type& F_left, const flux_type& F_right) {
+            double dx = grid[cell + 1] - grid[cell]; // ячейки обычно одинаковой длины, но мало ли..
+            if constexpr (FaceApproximation::courant_limited) {
+                double Cr = std::abs(v) * dt / dx;
+                if (Cr > 1) {
+                    throw std::runtime_error("Finite volume solver is called with Cr > 1");
                 }
-                F[right_border] = Ub * Vb;
             }
+            traits::update(U[cell], dt / dx, F_left, F_right, U_new[cell]);
+        };
+
+        flux_type F_left;
+        flux_type F_right;
+        if (v >= 0) {
+            // поток через правую границу донорской ячейки, проход по потоку
+            traits::boundary_flux(v, u_in, F_left);
+            store_flux(0, F_left);
+            face_flux(U[0], U[0], U[1], 0, F_right); // костыль U_L = U_C
+            store_flux(1, F_right);
+            update_cell(0, F_left, F_right);
+            F_left = F_right;
+            for (size_t cell = 1; cell < last; ++cell) {
+                face_flux(U[cell - 1], U[cell], U[cell + 1], cell, F_right);
+                store_flux(cell + 1, F_right);
+                update_cell(cell, F_left, F_right);
+                F_left = F_right;
+            }
+            face_flux(U[last - 1], U[last], U[last], last, F_right); // костыль U_R = U_C
+            store_flux(last + 1, F_right);
+            update_cell(last, F_left, F_right);
         }
         else {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t left_border = cell;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quickest_border_approximation(U[cell + 1], U[cell], U[cell], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_L = U_C
+            // поток через левую границу донорской ячейки, проход против направления оси
+            // если на выходе поток вытекает, то берется значение из последней ячейки
+            if (v_out <= 0) {
+                traits::boundary_flux(v_out, u_out, F_right);
+            }
+            else {
+                traits::boundary_flux(v_out, U[last], F_right);
+            }
+            store_flux(last + 1, F_right);
+            face_flux(U[last], U[last], U[last - 1], last, F_left); // костыль U_L = U_C
+            store_flux(last, F_left);
+            update_cell(last, F_left, F_right);
+            F_right = F_left;
+            for (size_t cell = last - 1; cell > 0; --cell) {
+                face_flux(U[cell + 1], U[cell], U[cell - 1], cell, F_left);
+                store_flux(cell, F_left);
+                update_cell(cell, F_left, F_right);
+                F_right = F_left;
+            }
+            face_flux(U[1], U[0], U[0], 0, F_left); // костыль U_R = U_C
+            store_flux(0, F_left);
+            update_cell(0, F_left, F_right);
+        }
+    }
+
+    /// @brief Шаг с заданными скоростями на границах ячеек
+    /// Направление потока и число Куранта определяются для каждой границы отдельно 
+    /// (по длине донорской ячейки). Проход по границам слева направо, 
+    /// поток на левой границе ячейки переносится с предыдущей итерации
+    /// @tparam KeepFlux Сохранять ли потоки в flux
+    /// @param velocity Скорость на границе velocity(face), вызывается один раз на границу
+    /// Остальные параметры - как в step_uniform_velocity
+    template <bool KeepFlux, typename Velocity>
+    static void step_variable_velocity(const vector<double>& grid, double dt, Velocity&& velocity,
+        const Value* U, Value* U_new, size_t cell_count,
+        const boundary_type& u_in, const boundary_type& u_out, flux_type* flux)
+    {
+        const double* x = grid.data();
+        const size_t last = cell_count - 1;
+
+        // Поток на границе face между ячейками face - 1 и face, на крайних ячейках 
+        // недостающий сосед заменяется самой ячейкой
+        auto calc_face_flux = [&](size_t face, flux_type& F) {
+            double v = velocity(face);
+            if (v >= 0) {
+                if (face == 0) {
+                    traits::boundary_flux(v, u_in, F);
+                    return;
                 }
-                else if (cell == U.size() - 1) {
-                    Ub = quickest_border_approximation(U[cell], U[cell], U[cell - 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_R = U_C
+                size_t donor = face - 1;
+                double dx = x[donor + 1] - x[donor];
+                if constexpr (FaceApproximation::courant_limited) {
+                    if (v * dt / dx > 1) {
+                        throw std::runtime_error("Finite volume solver is called with Cr > 1");
+                    }
+                }
+                traits::template face_flux<FaceApproximation>(
+                    U[donor > 0 ? donor - 1 : 0], U[donor], U[donor < last ? donor + 1 : last],
+                    dx, dt, v, F);
+            }
+            else {
+                if (face == last + 1) {
+                    traits::boundary_flux(v, u_out, F);
+                    return;
                 }
-                else {
-                    Ub = quickest_border_approximation(U[cell + 1], U[cell], U[cell - 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // честный расчет
+                size_t donor = face;
+                double dx = x[donor + 1] - x[donor];
+                if constexpr (FaceApproximation::courant_limited) {
+                    if (-v * dt / dx > 1) {
+                        throw std::runtime_error("Finite volume solver is called with Cr > 1");
+                    }
                 }
-                F[left_border] = Ub * Vb;
+                traits::template face_flux<FaceApproximation>(
+                    U[donor < last ? donor + 1 : last], U[donor], U[donor > 0 ? donor - 1 : 0],
+                    dx, dt, v, F);
             }
+        };
 
+        flux_type F_left;
+        flux_type F_right;
+        calc_face_flux(0, F_left);
+        if constexpr (KeepFlux) {
+            flux[0] = F_left;
         }
-
-        for (size_t cell = 0; cell < U.size(); ++cell) {
-            double dx = grid[cell + 1] - grid[cell]; // ячейки обычно одинаковой длины, но мало ли..
-            U_new[cell] = U[cell] + dt / dx * ((F[cell] - F[cell + 1]));
+        for (size_t cell = 0; cell <= last; ++cell) {
+            calc_face_flux(cell + 1, F_right);
+            if constexpr (KeepFlux) {
+                flux[cell + 1] = F_right;
+            }
+            traits::update(U[cell], dt / (x[cell + 1] - x[cell]), F_left, F_right, U_new[cell]);
+            F_left = F_right;
         }
-
     }
 };
 
@@ -446,11 +441,19 @@ struct quickest_ultimate_fv_wrapper<1> {
     {}
 };
 
-/// @brief Солвер на основе QUICKEST-ULTIMATE, только для размерности 1!
-/// [Leonard 1991]
-class quickest_ultimate_fv_solver {
+/// @brief Солвер метода конечных объемов для уравнения адвекции, только для размерности 1!
+/// Схема определяется политикой аппроксимации значения на границе ячейки (см. fv_upstream_face_t и др.),
+/// которая подставляется на этапе компиляции и встраивается во внутренний цикл.
+/// Скорость берется из уравнения в первой точке и считается одинаковой на всех границах ячеек,
+/// кроме политик с per_face_velocity (upstream), для которых скорость берется на каждой границе.
+/// Шаг выполняется ядром fv_kernel_t
+/// @tparam FaceApproximation Политика аппроксимации значения на границе ячейки
+/// @tparam Scalar Тип хранения переменных. Для float переменные хранятся с одинарной точностью,
+/// а потоки и приращения считаются в double (см. тест QUICKEST_ULTIMATE.FloatStorageMatchesDoubleStorage)
+template <typename FaceApproximation, typename Scalar = double>
+class fv_solver_t {
 public:
-    typedef typename quickest_ultimate_fv_solver_traits<1>::var_layer_data var_layer_data;
+    typedef typename quickest_ultimate_fv_solver_traits<1, Scalar>::var_layer_data var_layer_data;
     typedef typename quickest_ultimate_fv_solver_traits<1>::specific_layer specific_layer;
     typedef typename fixed_system_types<1>::matrix_type matrix_type;
     typedef typename fixed_system_types<1>::var_type vector_type;
@@ -462,22 +465,22 @@ protected:
     /// @brief Количество точек сетки
     const size_t n;
     /// @brief Предыдущий слой переменных
-    const vector<double>& prev_vars;
+    const vector<Scalar>& prev_vars;
     /// @brief Новый (рассчитываемый) слой переменных
-    vector<double>& curr_vars;
+    vector<Scalar>& curr_vars;
     /// @brief Предыдущий специфический слой (сейчас не нужен! нужен ли в будущем?)
-    const specific_layer& prev_spec;
-    /// @brief Текущий специфический слой
-    specific_layer& curr_spec;
+    const specific_layer* prev_spec{ nullptr };
+    /// @brief Текущий специфический слой (nullptr, если потоки не сохраняются, см. step_fused)
+    specific_layer* curr_spec{ nullptr };
 public:
     /// @brief Конструктор для буфера в котором простой слой:
     /// когда в слое только один блок целевых переменных и один блок служебных данных
     /// Из буфера берется current() и previous()
     /// @param pde ДУЧП
     /// @param buffer Буфер слоев
-    quickest_ultimate_fv_solver(pde_t<1>& pde,
+    fv_solver_t(pde_t<1>& pde,
         ring_buffer_t<composite_layer_t<var_layer_data, specific_layer>>& buffer)
-        : quickest_ultimate_fv_solver(pde, buffer.previous(), buffer.current())
+        : fv_solver_t(pde, buffer.previous(), buffer.current())
     {}
 
     /// @brief Конструктор для простых слоев - 
@@ -485,16 +488,11 @@ public:
     /// @param pde ДУЧП
     /// @param prev Предыдущий слой (уже рассчитанный)
     /// @param curr Следующий (новый), для которого требуется сделать расчет
-    quickest_ultimate_fv_solver(pde_t<1>& pde,
+    fv_solver_t(pde_t<1>& pde,
         const composite_layer_t<var_layer_data, specific_layer>& prev,
         composite_layer_t<var_layer_data, specific_layer>& curr)
-        : pde(pde)
-        , grid(pde.get_grid())
-        , n(pde.get_grid().size())
-        , prev_vars(prev.vars.cell_double[0])
-        , curr_vars(curr.vars.cell_double[0])
-        , prev_spec(std::get<0>(prev.specific))
-        , curr_spec(std::get<0>(curr.specific))
+        : fv_solver_t(pde, prev.vars.cell_double[0], curr.vars.cell_double[0],
+            std::get<0>(prev.specific), std::get<0>(curr.specific))
     {
 
     }
@@ -502,99 +500,529 @@ public:
     /// (созданного с помощью ring_buffer_t::get_custom_buffer)
     /// @param pde ДУЧП
     /// @param wrapper Буфер оберток
-    quickest_ultimate_fv_solver(pde_t<1>& pde,
+    fv_solver_t(pde_t<1>& pde,
         ring_buffer_t<quickest_ultimate_fv_wrapper<1>>& wrapper)
-        : pde(pde)
-        , grid(pde.get_grid())
-        , n(pde.get_grid().size())
-        , prev_vars(wrapper.previous().vars)
-        , curr_vars(wrapper.current().vars)
-        , prev_spec(wrapper.previous().specific)
-        , curr_spec(wrapper.current().specific)
+        : fv_solver_t(pde, wrapper.previous().vars, wrapper.current().vars,
+            wrapper.previous().specific, wrapper.current().specific)
+    {}
+    /// @brief Конструктор на основе представления буфера с обертками quickest_ultimate_fv_wrapper
+    /// (созданного с помощью ring_buffer_t::get_buffer_view)
+    template <typename LayerType, typename Selector>
+    fv_solver_t(pde_t<1>& pde,
+        const ring_buffer_view_t<LayerType, Selector>& view)
+        : fv_solver_t(pde, view.previous().vars, view.current().vars,
+            view.previous().specific, view.current().specific)
     {}
     /// @brief Конструктор, заточенный для удобства выдергивания специфического слоя, если он один в буфере
     /// Очень специфический
-    quickest_ultimate_fv_solver(pde_t<1>& pde,
-        const vector<double>& prev_vars, vector<double>& curr_vars,
+    fv_solver_t(pde_t<1>& pde,
+        const vector<Scalar>& prev_vars, vector<Scalar>& curr_vars,
         const specific_layer& prev_spec, specific_layer& curr_spec)
         : pde(pde)
         , grid(pde.get_grid())
         , n(pde.get_grid().size())
         , prev_vars(prev_vars)
         , curr_vars(curr_vars)
-        , prev_spec(prev_spec)
-        , curr_spec(curr_spec)
+        , prev_spec(&prev_spec)
+        , curr_spec(&curr_spec)
+    {
+
+    }
+    /// @brief Конструктор без специфического слоя - только для step_fused без сохранения потоков
+    /// @param pde ДУЧП
+    /// @param prev_vars Предыдущий слой (уже рассчитанный)
+    /// @param curr_vars Следующий (новый), для которого требуется сделать расчет
+    fv_solver_t(pde_t<1>& pde,
+        const vector<Scalar>& prev_vars, vector<Scalar>& curr_vars)
+        : pde(pde)
+        , grid(pde.get_grid())
+        , n(pde.get_grid().size())
+        , prev_vars(prev_vars)
+        , curr_vars(curr_vars)
     {
 
     }
+    /// @brief Конструктор для буфера профилей без специфического слоя (см. step_fused)
+    fv_solver_t(pde_t<1>& pde, ring_buffer_t<vector<Scalar>>& buffer)
+        : fv_solver_t(pde, buffer.previous(), buffer.current())
+    {}
+
+protected:
+    typedef fv_kernel_t<FaceApproximation, Scalar> kernel_type;
 
-    /// @brief Расчет шага
+public:
+    /// @brief Расчет шага с сохранением потоков в специфический слой
     /// @param dt Заданный период времени
     /// @param u_in Левое граничное условие
     /// @param u_out Правое граничное условие
     void step(double dt, double u_in, double u_out) {
-        auto& F = curr_spec.point_double[0]; // потоки на границах ячеек
-        const auto& U = prev_vars;
-        auto& U_new = curr_vars;
-
-        // Расчет потоков на границе на основе граничных условий
-        double v_in = pde.getEquationsCoeffs(0, U[0]);
-        double v_out = pde.getEquationsCoeffs(F.size() - 1, U[U.size() - 1]);
-        if (v_in >= 0) {
-            F.front() = v_in * u_in;
-        }
-        if (v_out <= 0) {
-            F.back() = v_out * u_out;
-        }
-
-        double v_pipe = pde.getEquationsCoeffs(0, U[0]);//не совсем корректно, скорость в ячейке берется из скорости на ее левой границе
-        // Расчет потоков на границе по правилу QUICK
-        if (v_pipe >= 0) {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t right_border = cell + 1;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quickest_ultimate_border_approximation(U[cell], U[cell], U[cell + 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_L = U_C
-                }
-                else if (cell == U.size() - 1) {
-                    Ub = quickest_ultimate_border_approximation(U[cell - 1], U[cell], U[cell], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_R = U_C
-                }
-                else {
-                    Ub = quickest_ultimate_border_approximation(U[cell - 1], U[cell], U[cell + 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // честный расчет
-                }
-                F[right_border] = Ub * Vb;
+        if (curr_spec == nullptr) {
+            throw std::logic_error("Finite volume solver is created without specific layer, use step_fused");
+        }
+        step_fused(dt, u_in, u_out, &curr_spec->point_double[0]);
+    }
+
+    /// @brief Расчет шага за один проход по ячейкам
+    /// Поток через каждую границу ячейки считается один раз и переносится в соседнюю ячейку,
+    /// поэтому отдельный проход по массиву потоков не нужен
+    /// @param dt Заданный период времени
+    /// @param u_in Левое граничное условие
+    /// @param u_out Правое граничное условие
+    /// @param flux Если задан, в него сохраняются потоки на границах ячеек
+    void step_fused(double dt, double u_in, double u_out, vector<double>* flux = nullptr) {
+        if constexpr (FaceApproximation::per_face_velocity) {
+            // скорость на границе face берется из уравнения по значению в донорской ячейке
+            const size_t last = prev_vars.size() - 1;
+            auto velocity = [&](size_t face) {
+                return pde.getEquationsCoeffs(face, prev_vars[std::min(face, last)]);
+            };
+            if (flux != nullptr) {
+                step_variable_velocity_impl<true>(dt, velocity, u_in, u_out, flux->data());
+            }
+            else {
+                step_variable_velocity_impl<false>(dt, velocity, u_in, u_out, nullptr);
             }
         }
+        else if (flux != nullptr) {
+            step_fused_impl<true>(dt, u_in, u_out, flux->data());
+        }
         else {
-            for (size_t cell = 0; cell < U.size(); ++cell) {
-                size_t left_border = cell;
-                double Vb = v_pipe; // предположили, что скорость на границе во всех точках трубы одна и та же
-                double Ub;
-                if (cell == 0) {
-                    Ub = quickest_ultimate_border_approximation(U[cell + 1], U[cell], U[cell], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_L = U_C
-                }
-                else if (cell == U.size() - 1) {
-                    Ub = quickest_ultimate_border_approximation(U[cell], U[cell], U[cell - 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // костыль U_R = U_C
-                }
-                else {
-                    Ub = quickest_ultimate_border_approximation(U[cell + 1], U[cell], U[cell - 1], 0, grid[cell + 1] - grid[cell], dt, v_pipe); // честный расчет
-                }
-                F[left_border] = Ub * Vb;
+            step_fused_impl<false>(dt, u_in, u_out, nullptr);
+        }
+    }
+
+    /// @brief Расчет шага с заданными скоростями на границах ячеек (см. PipeQAdvection::calc_face_velocities)
+    /// Направление потока и число Куранта определяются для каждой границы отдельно 
+    /// (по длине донорской ячейки), поэтому скорость может меняться по трубе и менять знак.
+    /// Уравнение во внутреннем цикле не вызывается.
+    /// При одинаковой по трубе скорости результат совпадает с step_fused
+    /// @param dt Заданный период времени
+    /// @param face_velocity Скорости на границах ячеек (в точках сетки)
+    /// @param u_in Левое граничное условие (используется при втекании)
+    /// @param u_out Правое граничное условие (используется при втекании)
+    /// @param flux Если задан, в него сохраняются потоки на границах ячеек
+    void step_variable_velocity(double dt, const vector<double>& face_velocity, 
+        double u_in, double u_out, vector<double>* flux = nullptr) 
+    {
+        if (face_velocity.size() != n) {
+            throw std::logic_error("Face velocity profile size must be equal to grid point count");
+        }
+        const double* v = face_velocity.data();
+        auto velocity = [v](size_t face) { return v[face]; };
+        if (flux != nullptr) {
+            step_variable_velocity_impl<true>(dt, velocity, u_in, u_out, flux->data());
+        }
+        else {
+            step_variable_velocity_impl<false>(dt, velocity, u_in, u_out, nullptr);
+        }
+    }
+
+protected:
+    /// @brief Реализация step_variable_velocity (см. fv_kernel_t::step_variable_velocity)
+    /// @tparam KeepFlux Сохранять ли потоки в flux
+    /// @param velocity Скорость на границе velocity(face)
+    template <bool KeepFlux, typename Velocity>
+    void step_variable_velocity_impl(double dt, Velocity&& velocity,
+        double u_in, double u_out, double* flux) 
+    {
+        kernel_type::template step_variable_velocity<KeepFlux>(grid, dt, velocity,
+            prev_vars.data(), curr_vars.data(), prev_vars.size(), u_in, u_out, flux);
+    }
+
+    /// @brief Реализация step_fused (см. fv_kernel_t::step_uniform_velocity)
+    /// @tparam KeepFlux Сохранять ли потоки в flux
+    template <bool KeepFlux>
+    void step_fused_impl(double dt, double u_in, double u_out, double* flux) {
+        const size_t last = prev_vars.size() - 1;
+        //не совсем корректно, скорость в ячейке берется из скорости на ее левой границе
+        // Предполагаем, что скорость на границе во всех точках трубы одна и та же
+        double v = pde.getEquationsCoeffs(0, prev_vars[0]);
+        double v_out = pde.getEquationsCoeffs(n - 1, prev_vars[last]);
+        kernel_type::template step_uniform_velocity<KeepFlux>(grid, dt, v, v_out,
+            prev_vars.data(), curr_vars.data(), prev_vars.size(), u_in, u_out, flux);
+    }
+
+public:
+    /// @brief Многошаговый расчет с постоянным шагом. Сдвигает буфер сам, 
+    /// солверы создаются один раз на все шаги (см. multistep_runner_t)
+    /// @param pde ДУЧП
+    /// @param buffer Буфер слоев, текущий слой - начальные условия
+    /// @param step_count Количество шагов
+    /// @param dt Шаг по времени
+    /// @param boundaries Граничные условия на шаге boundaries(step_index) -> пара (u_in, u_out)
+    /// @param observer Наблюдатель observer(step_index, dt, buffer.current())
+    /// @return Суммарное время расчета
+    template <typename BoundaryProvider, typename Observer = no_step_observer_t>
+    static double run(pde_t<1>& pde,
+        ring_buffer_t<composite_layer_t<var_layer_data, specific_layer>>& buffer,
+        size_t step_count, double dt,
+        BoundaryProvider&& boundaries, Observer&& observer = Observer())
+    {
+        typedef composite_layer_t<var_layer_data, specific_layer> layer_type;
+        multistep_runner_t<fv_solver_t, layer_type> runner(buffer,
+            [&](layer_type& prev, layer_type& curr) { return fv_solver_t(pde, prev, curr); });
+
+        return runner.run(step_count,
+            [&](fv_solver_t& solver, size_t step_index) {
+                std::pair<double, double> values = boundaries(step_index);
+                solver.step(dt, values.first, values.second);
+                return dt;
+            },
+            observer);
+    }
+};
+
+/// @brief Солвер на основе upstream differencing [Leonard 1979]
+typedef fv_solver_t<fv_upstream_face_t> upstream_fv_solver;
+/// @brief Солвер на основе QUICK [Leonard 1979]
+typedef fv_solver_t<fv_quick_face_t> quick_fv_solver;
+/// @brief Солвер на основе QUICKEST [Neumann 2011]
+typedef fv_solver_t<fv_quickest_face_t> quickest_fv_solver;
+/// @brief Солвер на основе QUICKEST-ULTIMATE [Leonard 1991]
+typedef fv_solver_t<fv_quickest_ultimate_face_t> quickest_ultimate_fv_solver;
+/// @brief TVD-солвер с ограничителем ван Леера
+typedef fv_solver_t<fv_van_leer_face_t> van_leer_fv_solver;
+/// @brief TVD-солвер с ограничителем superbee
+typedef fv_solver_t<fv_superbee_face_t> superbee_fv_solver;
+
+/// @brief Расчет шага конечных объемов с внутренним дроблением (sub-cycling) по числу Куранта
+/// Внешний шаг dt разбивается на одинаковые подшаги так, чтобы максимальное по трубе 
+/// число Куранта не превышало целевого. При малых расходах делается один подшаг.
+/// Скорости на границах ячеек считаются один раз на внешний шаг: для моделей с calc_face_velocities 
+/// (см. pde_has_face_velocities) - одним вызовом, иначе через getEquationsCoeffs на каждой границе.
+/// Промежуточные слои хранятся в собственном буфере, память выделяется один раз в конструкторе
+/// @tparam FaceApproximation Политика аппроксимации значения на границе ячейки (см. fv_upstream_face_t и др.)
+/// @tparam Scalar Тип хранения переменных (см. fv_solver_t)
+/// @tparam Pde Тип уравнения (например, PipeQAdvection)
+template <typename FaceApproximation, typename Scalar = double, typename Pde = pde_t<1>>
+class fv_subcycling_solver_t {
+protected:
+    typedef fv_kernel_t<FaceApproximation, Scalar> kernel_type;
+    /// @brief ДУЧП
+    Pde& pde;
+    /// @brief Целевое число Куранта подшага
+    const double target_courant;
+    /// @brief Минимальная длина ячейки
+    double dx_min;
+    /// @brief Скорости на границах ячеек на текущем шаге
+    vector<double> face_velocity;
+    /// @brief Промежуточный слой
+    vector<Scalar> scratch;
+public:
+    /// @brief Конструктор
+    /// @param pde ДУЧП
+    /// @param target_courant Целевое число Куранта подшага, (0, 1]
+    fv_subcycling_solver_t(Pde& pde, double target_courant = 0.9)
+        : pde(pde)
+        , target_courant(target_courant)
+        , face_velocity(pde.get_grid().size())
+        , scratch(pde.get_grid().size() - 1)
+    {
+        if (target_courant <= 0 || target_courant > 1) {
+            throw std::logic_error("Target Courant number must be in (0, 1]");
+        }
+        const vector<double>& grid = pde.get_grid();
+        dx_min = std::numeric_limits<double>::max();
+        for (size_t index = 1; index < grid.size(); ++index) {
+            dx_min = std::min(dx_min, grid[index] - grid[index - 1]);
+        }
+    }
+
+    /// @brief Количество подшагов для внешнего шага dt при текущих скоростях на границах
+    size_t get_substep_count(double dt) const {
+        double v_max = 0;
+        for (double v : face_velocity) {
+            v_max = std::max(v_max, std::abs(v));
+        }
+        double courant = v_max * dt / dx_min;
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(courant / target_courant)));
+    }
+
+    /// @brief Расчет внешнего шага
+    /// Слои - любые непрерывные профили значений Scalar с data() и size() 
+    /// (vector<Scalar>, profile_span_t и т.д.)
+    /// @param dt Внешний шаг по времени
+    /// @param prev_vars Предыдущий слой (уже рассчитанный)
+    /// @param curr_vars Следующий (новый), для которого требуется сделать расчет
+    /// @param u_in Левое граничное условие (постоянное на всех подшагах)
+    /// @param u_out Правое граничное условие (постоянное на всех подшагах)
+    /// @return Количество сделанных подшагов
+    template <typename PrevProfile, typename CurrProfile>
+    size_t step(double dt, const PrevProfile& prev_vars, CurrProfile& curr_vars,
+        double u_in, double u_out)
+    {
+        const Scalar* prev_data = prev_vars.data();
+        Scalar* curr_data = curr_vars.data();
+        const size_t cell_count = prev_vars.size();
+        if (cell_count != scratch.size() || curr_vars.size() != cell_count) {
+            throw std::logic_error("Layer size must be equal to grid cell count");
+        }
+
+        if constexpr (pde_has_face_velocities<Pde>::value) {
+            pde.calc_face_velocities(&face_velocity);
+        }
+        else {
+            for (size_t index = 0; index < face_velocity.size(); ++index) {
+                face_velocity[index] = pde.getEquationsCoeffs(index, prev_data[std::min(index, cell_count - 1)]);
             }
+        }
+
+        size_t substep_count = get_substep_count(dt);
+        double substep = dt / substep_count;
 
+        // Подшаги чередуют промежуточный и новый слой так, чтобы последний подшаг попал в новый слой
+        const vector<double>& grid = pde.get_grid();
+        const double* v = face_velocity.data();
+        auto velocity = [v](size_t face) { return v[face]; };
+        const Scalar* source = prev_data;
+        for (size_t index = 0; index < substep_count; ++index) {
+            Scalar* target = (substep_count - 1 - index) % 2 == 0
+                ? curr_data
+                : scratch.data();
+            kernel_type::template step_variable_velocity<false>(grid, substep, velocity,
+                source, target, cell_count, u_in, u_out, nullptr);
+            source = target;
         }
+        return substep_count;
+    }
 
-        for (size_t cell = 0; cell < U.size(); ++cell) {
-            double dx = grid[cell + 1] - grid[cell]; // ячейки обычно одинаковой длины, но мало ли..
-            double Cr = v_in * dt / dx;
-            if (Cr > 1) {
-                throw std::runtime_error("Quickest-ultimate is called with Cr > 1");
+    /// @brief Расчет внешнего шага для буфера. Из буфера берется current() и previous()
+    template <typename Profile>
+    size_t step(double dt, ring_buffer_t<Profile>& buffer, double u_in, double u_out)
+    {
+        return step(dt, buffer.previous(), buffer.current(), u_in, u_out);
+    }
+};
+
+/// @brief Солвер QUICKEST-ULTIMATE с дроблением шага по числу Куранта
+typedef fv_subcycling_solver_t<fv_quickest_ultimate_face_t> quickest_ultimate_fv_subcycling_solver;
+
+/// @brief Солвер метода конечных объемов для переноса нескольких параметров (плотность, вязкость,
+/// сера и т.д.) одним потоком, только для размерности 1!
+/// Значения параметров в ячейке хранятся подряд (std::array), поэтому скорость, длина ячейки 
+/// и число Куранта считаются один раз на границу, а внутренний цикл идет по компонентам.
+/// Шаг делается тем же ядром fv_kernel_t, что и в fv_solver_t, поэтому
+/// для каждой компоненты результат совпадает с fv_solver_t::step_fused
+/// @tparam FaceApproximation Политика аппроксимации значения на границе ячейки (см. fv_upstream_face_t и др.)
+/// @tparam Components Количество переносимых параметров
+template <typename FaceApproximation, size_t Components>
+class fv_multicomponent_solver_t {
+public:
+    /// @brief Значения всех параметров в одной ячейке
+    typedef std::array<double, Components> component_values_t;
+    /// @brief Профиль значений параметров по ячейкам
+    typedef vector<component_values_t> profile_type;
+protected:
+    /// @brief ДУЧП
+    pde_t<1>& pde;
+    /// @brief Сетка, полученная от ДУЧП
+    const vector<double>& grid;
+    /// @brief Количество точек сетки
+    const size_t n;
+    /// @brief Предыдущий слой переменных
+    const profile_type& prev_vars;
+    /// @brief Новый (рассчитываемый) слой переменных
+    profile_type& curr_vars;
+public:
+    /// @brief Конструктор для слоев
+    /// @param pde ДУЧП
+    /// @param prev_vars Предыдущий слой (уже рассчитанный)
+    /// @param curr_vars Следующий (новый), для которого требуется сделать расчет
+    fv_multicomponent_solver_t(pde_t<1>& pde, const profile_type& prev_vars, profile_type& curr_vars)
+        : pde(pde)
+        , grid(pde.get_grid())
+        , n(pde.get_grid().size())
+        , prev_vars(prev_vars)
+        , curr_vars(curr_vars)
+    {
+
+    }
+    /// @brief Конструктор для буфера слоев. Из буфера берется current() и previous()
+    fv_multicomponent_solver_t(pde_t<1>& pde, ring_buffer_t<profile_type>& buffer)
+        : fv_multicomponent_solver_t(pde, buffer.previous(), buffer.current())
+    {}
+
+    /// @brief Расчет шага за один проход по ячейкам для всех параметров (см. fv_kernel_t)
+    /// @param dt Заданный период времени
+    /// @param u_in Левые граничные условия по параметрам
+    /// @param u_out Правые граничные условия по параметрам
+    void step(double dt, const component_values_t& u_in, const component_values_t& u_out) {
+        typedef fv_kernel_t<FaceApproximation, component_values_t> kernel_type;
+        const size_t last = prev_vars.size() - 1;
+        if constexpr (FaceApproximation::per_face_velocity) {
+            auto velocity = [&](size_t face) {
+                return pde.getEquationsCoeffs(face, prev_vars[std::min(face, last)][0]);
+            };
+            kernel_type::template step_variable_velocity<false>(grid, dt, velocity,
+                prev_vars.data(), curr_vars.data(), prev_vars.size(), u_in, u_out, nullptr);
+        }
+        else {
+            // скорость одна и та же на всех границах (как в fv_solver_t)
+            double v = pde.getEquationsCoeffs(0, prev_vars[0][0]);
+            double v_out = pde.getEquationsCoeffs(n - 1, prev_vars[last][0]);
+            kernel_type::template step_uniform_velocity<false>(grid, dt, v, v_out,
+                prev_vars.data(), curr_vars.data(), prev_vars.size(), u_in, u_out, nullptr);
+        }
+    }
+};
+
+/// @brief Солвер QUICKEST-ULTIMATE для нескольких переносимых параметров
+template <size_t Components>
+using quickest_ultimate_fv_multicomponent_solver = fv_multicomponent_solver_t<fv_quickest_ultimate_face_t, Components>;
+
+/// @brief Солвер метода конечных объемов для ансамбля сценариев одной трубы, только для размерности 1!
+/// Сценарии отличаются начальными профилями, скоростью потока (постоянной по трубе) и граничными условиями.
+/// Все сценарии рассчитываются за один проход по ячейкам, внутренний цикл - по сценариям 
+/// (см. ensemble_profile_t) и идет подряд по всем сценариям. Поток через границу считается 
+/// операциями fv_value_traits для обоих направлений (донорская ячейка слева и справа), 
+/// нужный выбирается по знаку скорости сценария условным присваиванием, поэтому внутренние циклы 
+/// не ветвятся и векторизуются. Для каждого сценария результат совпадает с fv_solver_t
+/// @tparam FaceApproximation Политика аппроксимации значения на границе ячейки (см. fv_upstream_face_t и др.)
+template <typename FaceApproximation>
+class fv_ensemble_solver_t {
+public:
+    typedef typename quickest_ultimate_fv_ensemble_traits::var_layer_data var_layer_data;
+    typedef typename quickest_ultimate_fv_ensemble_traits::specific_layer specific_layer;
+    typedef composite_layer_t<var_layer_data, specific_layer> layer_type;
+protected:
+    /// @brief Сетка
+    const vector<double>& grid;
+    /// @brief Скорости потока по сценариям
+    const vector<double>& velocity;
+    /// @brief Количество сценариев
+    const size_t scenario_count;
+    /// @brief Предыдущий слой переменных
+    const ensemble_profile_t<double>& prev_vars;
+    /// @brief Новый (рассчитываемый) слой переменных
+    ensemble_profile_t<double>& curr_vars;
+    /// @brief Потоки на границах ячеек нового слоя
+    ensemble_profile_t<double>& curr_flux;
+
+    typedef fv_value_traits<double> traits;
+
+    /// @brief Потоки через внутреннюю границу для всех сценариев
+    /// Донорская ячейка при прямом потоке - слева от границы (соседи U_LL, U_R), 
+    /// при обратном - справа (соседи U_RR, U_L)
+    void calc_face_flux(double dt, double dx_L, double dx_R,
+        const double* U_LL, const double* U_L, const double* U_R, const double* U_RR, double* F) const
+    {
+        const double* v = velocity.data();
+        for (size_t k = 0; k < scenario_count; ++k) {
+            double F_forward;
+            double F_backward;
+            traits::face_flux<FaceApproximation>(U_LL[k], U_L[k], U_R[k], dx_L, dt, v[k], F_forward);
+            traits::face_flux<FaceApproximation>(U_RR[k], U_R[k], U_L[k], dx_R, dt, v[k], F_backward);
+            F[k] = v[k] >= 0 ? F_forward : F_backward;
+        }
+    }
+public:
+    /// @brief Конструктор для буфера слоев ансамбля
+    /// Из буфера берется current() и previous()
+    /// @param grid Сетка
+    /// @param velocity Скорости потока по сценариям
+    /// @param buffer Буфер слоев
+    fv_ensemble_solver_t(const vector<double>& grid, const vector<double>& velocity,
+        ring_buffer_t<layer_type>& buffer)
+        : fv_ensemble_solver_t(grid, velocity, buffer.previous(), buffer.current())
+    {}
+
+    /// @brief Конструктор для слоев ансамбля
+    /// @param grid Сетка
+    /// @param velocity Скорости потока по сценариям
+    /// @param prev Предыдущий слой (уже рассчитанный)
+    /// @param curr Следующий (новый), для которого требуется сделать расчет
+    fv_ensemble_solver_t(const vector<double>& grid, const vector<double>& velocity,
+        const layer_type& prev, layer_type& curr)
+        : grid(grid)
+        , velocity(velocity)
+        , scenario_count(velocity.size())
+        , prev_vars(prev.vars.cell_double[0])
+        , curr_vars(curr.vars.cell_double[0])
+        , curr_flux(std::get<0>(curr.specific).point_double[0])
+    {
+        if (prev_vars.get_scenario_count() != scenario_count ||
+            curr_vars.get_scenario_count() != scenario_count)
+        {
+            throw std::runtime_error("Ensemble layer and velocity scenario count mismatch");
+        }
+    }
+
+    /// @brief Расчет шага для всех сценариев
+    /// @param dt Заданный период времени
+    /// @param u_in Левые граничные условия по сценариям
+    /// @param u_out Правые граничные условия по сценариям
+    void step(double dt, const vector<double>& u_in, const vector<double>& u_out) {
+        const size_t cell_count = prev_vars.size();
+        const size_t last = cell_count - 1;
+        const ensemble_profile_t<double>& U = prev_vars;
+        ensemble_profile_t<double>& U_new = curr_vars;
+        ensemble_profile_t<double>& F = curr_flux;
+        const double* v = velocity.data();
+
+        if constexpr (FaceApproximation::courant_limited) {
+            double dx_min = std::numeric_limits<double>::max();
+            for (size_t cell = 0; cell < cell_count; ++cell) {
+                dx_min = std::min(dx_min, grid[cell + 1] - grid[cell]);
+            }
+            for (size_t k = 0; k < scenario_count; ++k) {
+                if (std::abs(v[k]) * dt / dx_min > 1) {
+                    throw std::runtime_error("Finite volume solver is called with Cr > 1 in scenario " +
+                        std::to_string(k));
+                }
+            }
+        }
+
+        // Левая граница трубы: при прямом потоке - граничное условие, 
+        // при обратном - вытекание из первой ячейки (костыль U_R = U_C, как в fv_kernel_t)
+        {
+            const double* U_0 = U.point_data(0);
+            const double* U_1 = U.point_data(std::min<size_t>(1, last));
+            double* F_in = F.point_data(0);
+            double dx = grid[1] - grid[0];
+            for (size_t k = 0; k < scenario_count; ++k) {
+                double F_forward;
+                double F_backward;
+                traits::boundary_flux(v[k], u_in[k], F_forward);
+                traits::face_flux<FaceApproximation>(U_1[k], U_0[k], U_0[k], dx, dt, v[k], F_backward);
+                F_in[k] = v[k] >= 0 ? F_forward : F_backward;
             }
-            U_new[cell] = U[cell] + dt / dx * ((F[cell] - F[cell + 1]));
         }
 
+        // Проход по ячейкам: поток на правой границе ячейки, затем новое значение в ячейке.
+        // На крайних ячейках недостающий сосед заменяется самой ячейкой
+        for (size_t cell = 0; cell < cell_count; ++cell) {
+            const double* U_C = U.point_data(cell);
+            const double* F_left = F.point_data(cell);
+            double* F_right = F.point_data(cell + 1);
+            double dx = grid[cell + 1] - grid[cell];
+
+            if (cell < last) {
+                calc_face_flux(dt, dx, grid[cell + 2] - grid[cell + 1],
+                    U.point_data(cell == 0 ? 0 : cell - 1), U_C, U.point_data(cell + 1),
+                    U.point_data(std::min(cell + 2, last)), F_right);
+            }
+            else {
+                // Правая граница трубы: при прямом потоке - вытекание из последней ячейки
+                // (костыль U_R = U_C), при обратном - граничное условие
+                const double* U_L = U.point_data(cell == 0 ? 0 : cell - 1);
+                for (size_t k = 0; k < scenario_count; ++k) {
+                    double F_forward;
+                    double F_backward;
+                    traits::face_flux<FaceApproximation>(U_L[k], U_C[k], U_C[k], dx, dt, v[k], F_forward);
+                    traits::boundary_flux(v[k], u_out[k], F_backward);
+                    F_right[k] = v[k] >= 0 ? F_forward : F_backward;
+                }
+            }
+
+            double* U_C_new = U_new.point_data(cell);
+            for (size_t k = 0; k < scenario_count; ++k) {
+                traits::update(U_C[k], dt / dx, F_left[k], F_right[k], U_C_new[k]);
+            }
+        }
     }
 };
 
+/// @brief Солвер QUICKEST-ULTIMATE для ансамбля сценариев одной трубы
+typedef fv_ensemble_solver_t<fv_quickest_ultimate_face_t> quickest_ultimate_fv_ensemble_solver;
+
 }
\ No newline at end of file
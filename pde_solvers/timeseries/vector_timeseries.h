@@ -52,6 +52,24 @@ public:
         return end_date;
     }
 
+    /// @brief Положение курсора: для каждого ряда индекс левой границы последнего интервала интерполяции
+    /// Нужен для сохранения и восстановления расчета (см. save_checkpoint)
+    const vector<size_t>& get_cursor() const {
+        return left_bound;
+    }
+    /// @brief Восстанавливает положение курсора, полученное из get_cursor
+    void set_cursor(const vector<size_t>& cursor) {
+        if (cursor.size() != data.size()) {
+            throw std::runtime_error("Timeseries cursor size mismatch");
+        }
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (cursor[i] >= std::max<size_t>(1, data[i].first.size())) {
+                throw std::runtime_error("Timeseries cursor is out of range");
+            }
+        }
+        left_bound = cursor;
+    }
+
     /// @brief Возвращает интерполированные значения 
     /// временных рядов в момент времени t
     /// @param t Момент времени
@@ -77,6 +77,8 @@ public:
     using ode_t<1>::equation_coeffs_type;
     using ode_t<1>::right_party_type;
     using ode_t<1>::var_type;
+    /// @brief Градиент давления не зависит от давления - профиль считается префиксной суммой (solve_euler_scan)
+    static constexpr bool has_state_independent_right_party = true;
 protected:
     const vector<double>& rho_profile;
     const vector<double>& nu_profile;
@@ -243,7 +245,7 @@ public:
         // Начальный гидравлический расчет
         int euler_direction = +1;
         pipe_model_PQ_cell_parties_t pipeModel(pipe, current.density, current.viscosity, initial_conditions.volumetric_flow, euler_direction);
-        solve_euler<1>(pipeModel, euler_direction, initial_conditions.pressure_in, &current.pressure);
+        solve_euler_scan(pipeModel, euler_direction, initial_conditions.pressure_in, &current.pressure);
 
         buffer.pressure_initial = current.pressure; // Получаем изначальный профиль давлений
     }
@@ -261,10 +263,10 @@ private:
 
         PipeQAdvection advection_model(pipe, Q_profile);
 
-        auto density_wrapper = buffer.buffer.get_buffer_wrapper(
+        auto density_wrapper = buffer.buffer.get_buffer_view(
             &Layer::get_density_wrapper);
 
-        auto viscosity_wrapper = buffer.buffer.get_buffer_wrapper(
+        auto viscosity_wrapper = buffer.buffer.get_buffer_view(
             &Layer::get_viscosity_wrapper);
 
         if constexpr (std::is_same<Solver, moc_solver<1>>::value) {
@@ -295,7 +297,7 @@ private:
         int euler_direction = +1; // Задаем направление для Эйлера
 
         pipe_model_PQ_cell_parties_t pipeModel(pipe, current.density, current.viscosity, boundaries.volumetric_flow, euler_direction);
-        solve_euler<1>(pipeModel, euler_direction, boundaries.pressure_in, &p_profile);
+        solve_euler_scan(pipeModel, euler_direction, boundaries.pressure_in, &p_profile);
         // Получаем дифференциальный профиль давлений
         std::transform(buffer.pressure_initial.begin(), buffer.pressure_initial.end(), p_profile.begin(),
             current.pressure_delta.begin(),
@@ -77,4 +77,67 @@ TEST_F(AdvectionMocSolver, ConsiderFlowSwap)
     // Проверим, что давление изменилось в конце трубопровода, но не изменилось в начале
     ASSERT_NEAR(buffer.current().back(), rho_right, 0.05);
     ASSERT_NEAR(buffer.current().front(), rho_init, 0.05);
-}
\ No newline at end of file
+}
+
+/// @brief Циклический профиль при Cr = 1 дает тот же результат, что и копирующий солвер,
+/// при прямом и обратном течении
+TEST_F(AdvectionMocSolver, CircularProfileMatchesCopyingSolver)
+{
+    size_t n = pipe.profile.getPointCount();
+    vector<double> rho_start(n);
+    for (size_t index = 0; index < n; ++index) {
+        rho_start[index] = rho_init + index;
+    }
+
+    vector<double> Q(n);
+    PipeQAdvection advection_model(pipe, Q);
+
+    ring_buffer_t<vector<double>> buffer(2, rho_start);
+    ring_buffer_t<circular_profile_t<double>> circular_buffer(1, rho_start);
+
+    for (size_t step = 0; step < 3 * n; ++step) {
+        double volumetric_flow = step % 50 < 35 ? 0.5 : -0.3;
+        std::fill(Q.begin(), Q.end(), volumetric_flow);
+
+        advection_moc_solver solver(pipe, volumetric_flow, buffer.previous(), buffer.current());
+        solver.step(rho_left + step, rho_right - step);
+        buffer.advance(+1);
+
+        advection_circular_solver circular_solver(advection_model, circular_buffer);
+        ASSERT_NEAR(std::abs(solver.prepare_step()), circular_solver.prepare_step(), 1e-9);
+        circular_solver.step(rho_left + step, rho_right - step);
+
+        ASSERT_EQ(buffer.previous(), circular_buffer.current().get_profile());
+    }
+}
+
+/// @brief Расчет последовательности партий на циклическом профиле совпадает с копирующим солвером
+/// Партии сменяются чаще, чем проходят трубу, поэтому профиль хранит несколько границ партий
+TEST_F(AdvectionMocSolver, CircularProfileLongBatchTracking)
+{
+    simple_pipe_properties simple_pipe = simple_pipe_properties::sample_district();
+    pipe_properties_t long_pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = long_pipe.profile.getPointCount();
+
+    vector<double> Q(n, 0.5);
+    PipeQAdvection advection_model(long_pipe, Q);
+
+    constexpr size_t step_count = 300;
+    constexpr size_t batch_steps = 20;
+
+    ring_buffer_t<vector<double>> buffer(2, vector<double>(n, rho_init));
+    for (size_t step = 0; step < step_count; ++step) {
+        advection_moc_solver solver(long_pipe, Q[0], buffer.previous(), buffer.current());
+        solver.step(step % (2 * batch_steps) < batch_steps ? rho_left : rho_right, rho_init);
+        buffer.advance(+1);
+    }
+
+    ring_buffer_t<circular_profile_t<double>> circular_buffer(1, n);
+    circular_buffer.current().set_profile(vector<double>(n, rho_init));
+    for (size_t step = 0; step < step_count; ++step) {
+        advection_circular_solver solver(advection_model, circular_buffer);
+        solver.step(step % (2 * batch_steps) < batch_steps ? rho_left : rho_right, rho_init);
+    }
+
+    ASSERT_EQ(buffer.previous(), circular_buffer.current().get_profile());
+}
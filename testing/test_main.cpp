@@ -53,6 +53,7 @@ inline std::string prepare_research_folder()
 #include "test_advection_moc_solver.h"
 #include "test_synthetic_timeseries.h"
 #include "test_create_pipe_profile.h"
+#include "test_profile_structures.h"
 
 #include "../research/2023-12-diffusion-of-advection/diffusion_of_advection.h"
 #include "../research/2024-02-quick-with-quasistationary-model/quick_with_quasistationary_model.h"
@@ -220,3 +220,345 @@ TEST(MOC_Solver, UseCase_Waterhammer)
 
 }
 
+
+/// @brief Расчет гидроудара на сетке участка ТУ заданным типом солвера
+/// @tparam Solver Тип солвера метода характеристик
+/// @param pipeModel Модель трубы
+/// @param step_count Количество шагов
+/// @param duration [out] Время расчета шагов, с
+/// @param parallel Настройки многопоточного расчета
+/// @return Профили давления и расхода на последнем слое
+template <typename Solver>
+inline std::array<vector<double>, 2> moc_waterhammer_benchmark(
+    PipeModelPGConstArea& pipeModel, size_t step_count, double* duration,
+    const parallel_settings_t& parallel = parallel_settings_t())
+{
+    typedef composite_layer_t<profile_collection_t<2>, moc_solver<2>::specific_layer> composite_layer_type;
+    size_t n = pipeModel.get_grid().size();
+    ring_buffer_t<composite_layer_type> buffer(2, n);
+
+    double G = 400;
+    double Pout = 5e5;
+    profile_wrapper<double, 2> start_layer(get_profiles_pointers(buffer.current().vars.point_double));
+    solve_euler_corrector<2>(pipeModel, -1, { Pout, G }, &start_layer);
+
+    auto left_boundary = pipeModel.const_mass_flow_equation(G + 50);
+    auto right_boundary = pipeModel.const_pressure_equation(Pout);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < step_count; ++index) {
+        buffer.advance(+1);
+        moc_layer_wrapper<2> moc_current(buffer.current().vars, std::get<0>(buffer.current().specific));
+        moc_layer_wrapper<2> moc_previous(buffer.previous().vars, std::get<0>(buffer.previous().specific));
+
+        Solver solver(pipeModel, moc_previous, moc_current);
+        solver.parallel = parallel;
+        solver.step(left_boundary, right_boundary);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    *duration = std::chrono::duration<double>(finish - start).count();
+
+    return buffer.current().vars.point_double;
+}
+
+/// @brief Статический и виртуальный вызов уравнения в методе характеристик дают одинаковый результат
+TEST(MOC_Solver, StaticDispatchMatchesVirtualDispatch)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(
+        simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+
+    constexpr size_t step_count = 5;
+    double virtual_duration, static_duration;
+    auto virtual_result = moc_waterhammer_benchmark<moc_solver<2>>(
+        pipeModel, step_count, &virtual_duration);
+    auto static_result = moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(
+        pipeModel, step_count, &static_duration);
+
+    for (size_t dimension = 0; dimension < 2; ++dimension) {
+        for (size_t index = 0; index < virtual_result[dimension].size(); ++index) {
+            ASSERT_NEAR(virtual_result[dimension][index], static_result[dimension][index],
+                1e-12 * std::abs(virtual_result[dimension][index]));
+        }
+    }
+}
+
+/// @brief Сравнение быстродействия виртуального и статического вызова уравнения 
+/// в методе характеристик на участке ТУ. Только замер времени, 
+/// запускается явно: --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(MOC_Solver, DISABLED_StaticDispatchBenchmark)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(
+        simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+
+    constexpr size_t step_count = 50;
+    double virtual_duration, static_duration;
+    moc_waterhammer_benchmark<moc_solver<2>>(pipeModel, step_count, &virtual_duration);
+    moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(pipeModel, step_count, &static_duration);
+
+    std::cout << "Virtual dispatch: " << 1e3 * virtual_duration / step_count << " ms/step" << std::endl;
+    std::cout << "Static dispatch: " << 1e3 * static_duration / step_count << " ms/step" << std::endl;
+}
+
+/// @brief Статическая диспетчеризация требует точного совпадения типа модели с параметром шаблона
+TEST(MOC_Solver, StaticDispatchChecksModelType)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties());
+    oil_parameters_t oil;
+    vector<double> temperature(pipe.profile.getPointCount(), KELVIN_OFFSET + 20);
+    PipeModelPGConstAreaNonIsothermal pipeModel(pipe, oil, temperature);
+
+    typedef composite_layer_t<profile_collection_t<2>, moc_solver<2>::specific_layer> composite_layer_type;
+    ring_buffer_t<composite_layer_type> buffer(2, pipe.profile.getPointCount());
+    moc_layer_wrapper<2> moc_current(buffer.current().vars, std::get<0>(buffer.current().specific));
+    moc_layer_wrapper<2> moc_previous(buffer.previous().vars, std::get<0>(buffer.previous().specific));
+
+    typedef moc_solver<2, PipeModelPGConstArea> base_model_solver;
+    ASSERT_THROW(base_model_solver(pipeModel, moc_previous, moc_current), std::logic_error);
+}
+
+/// @brief Расчет гидроудара в режиме замороженной собственной системы на каждом шаге
+/// Возвращает профили давления и расхода после step_count шагов (см. moc_waterhammer_benchmark)
+inline std::array<vector<double>, 2> moc_frozen_waterhammer_benchmark(
+    PipeModelPGConstArea& pipeModel, size_t step_count, double* duration)
+{
+    // В замороженном режиме специфический слой не нужен
+    size_t n = pipeModel.get_grid().size();
+    ring_buffer_t<profile_collection_t<2>> buffer(2, n);
+    double G = 400;
+    double Pout = 5e5;
+    profile_wrapper<double, 2> start_layer(get_profiles_pointers(buffer.current().point_double));
+    solve_euler_corrector<2>(pipeModel, -1, { Pout, G }, &start_layer);
+
+    auto left_boundary = pipeModel.const_mass_flow_equation(G + 50);
+    auto right_boundary = pipeModel.const_pressure_equation(Pout);
+
+    moc_frozen_eigens_t<2> frozen(pipeModel);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < step_count; ++index) {
+        buffer.advance(+1);
+        moc_solver<2, PipeModelPGConstArea> solver(pipeModel, frozen, 
+            buffer.previous(), buffer.current());
+        solver.step(left_boundary, right_boundary);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    *duration = std::chrono::duration<double>(finish - start).count();
+
+    return buffer.current().point_double;
+}
+
+/// @brief Режим замороженных коэффициентов для модели с постоянной собственной системой 
+/// дает тот же результат, что и полный расчет собственных чисел/векторов на каждом шаге
+TEST(MOC_Solver, FrozenEigensMatchesFullEigenPass)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(
+        simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+    size_t n = pipeModel.get_grid().size();
+
+    constexpr size_t step_count = 50;
+    double full_duration, frozen_duration;
+    auto full_result = moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(
+        pipeModel, step_count, &full_duration);
+    auto frozen_result = moc_frozen_waterhammer_benchmark(pipeModel, step_count, &frozen_duration);
+
+    for (size_t dimension = 0; dimension < 2; ++dimension) {
+        for (size_t index = 0; index < n; ++index) {
+            ASSERT_NEAR(full_result[dimension][index], frozen_result[dimension][index],
+                1e-12 * std::abs(full_result[dimension][index]));
+        }
+    }
+}
+
+/// @brief Сравнение быстродействия расчета с замороженной собственной системой и с ее расчетом 
+/// в каждой точке. Только замер времени, запускается явно: --gtest_also_run_disabled_tests
+TEST(MOC_Solver, DISABLED_FrozenEigensBenchmark)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(
+        simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+
+    constexpr size_t step_count = 50;
+    double full_duration, frozen_duration;
+    moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(pipeModel, step_count, &full_duration);
+    moc_frozen_waterhammer_benchmark(pipeModel, step_count, &frozen_duration);
+
+    std::cout << "Full eigen pass: " << 1e3 * full_duration / step_count << " ms/step" << std::endl;
+    std::cout << "Frozen eigens: " << 1e3 * frozen_duration / step_count << " ms/step" << std::endl;
+}
+
+/// @brief Многопоточный расчет гидроудара побитово совпадает с последовательным
+TEST(MOC_Solver, ParallelStepIsBitIdentical)
+{
+#ifndef _OPENMP
+    GTEST_SKIP() << "Built without OpenMP, parallel calculation is serial";
+#endif
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(
+        simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+
+    constexpr size_t step_count = 50;
+    parallel_settings_t parallel = parallel_settings_t::with_threads(4);
+
+    double serial_duration, parallel_duration;
+    auto serial_result = moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(
+        pipeModel, step_count, &serial_duration);
+    auto parallel_result = moc_waterhammer_benchmark<moc_solver<2, PipeModelPGConstArea>>(
+        pipeModel, step_count, &parallel_duration, parallel);
+
+    ASSERT_EQ(serial_result, parallel_result);
+}
+
+/// @brief Многопоточный расчет переноса плотности (метод второго порядка) побитово 
+/// совпадает с последовательным при разном числе потоков и размере порций
+TEST(MOC_Solver, ParallelAdvectionStepIsBitIdentical)
+{
+#ifndef _OPENMP
+    GTEST_SKIP() << "Built without OpenMP, parallel calculation is serial";
+#endif
+    simple_pipe_properties simple_pipe;
+    simple_pipe.length = 50e3;
+    simple_pipe.diameter = 0.7;
+    simple_pipe.dx = 100;
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = pipe.profile.getPointCount();
+
+    // Переменный расход, чтобы характеристики попадали между узлами сетки
+    vector<double> Q(n);
+    for (size_t index = 0; index < n; ++index) {
+        Q[index] = 0.5 + 0.1 * sin(static_cast<double>(index) / 20);
+    }
+    PipeQAdvection advection_model(pipe, Q);
+
+    auto calc_density = [&](const parallel_settings_t& parallel) {
+        typedef composite_layer_t<profile_collection_t<1>, moc_solver<1>::specific_layer> single_var_moc_t;
+        ring_buffer_t<single_var_moc_t> buffer(2, n);
+        auto& rho_initial = buffer.current().vars.point_double[0];
+        for (size_t index = 0; index < n; ++index) {
+            rho_initial[index] = 850 + 5 * cos(static_cast<double>(index) / 7);
+        }
+        for (size_t step = 0; step < 20; ++step) {
+            buffer.advance(+1);
+            moc_solver<1> solver(advection_model, buffer.previous(), buffer.current());
+            solver.parallel = parallel;
+            double dt = 0.7 * solver.prepare_step();
+            solver.step2_optional_boundaries(dt, 840, 860);
+        }
+        return buffer.current().vars.point_double[0];
+    };
+
+    vector<double> serial = calc_density(parallel_settings_t());
+    for (int thread_count : { 2, 3, 8 }) {
+        parallel_settings_t parallel = parallel_settings_t::with_threads(thread_count);
+        parallel.chunk_size = 37;
+        ASSERT_EQ(serial, calc_density(parallel));
+    }
+}
+
+/// @brief Специализированное ядро 2x2 для замороженной собственной системы дает 
+/// те же значения внутренних точек, что и общий шаг step_inner с собственной системой в каждой точке.
+/// Сетка неравномерная, поэтому смещения характеристик в каждой точке разные
+TEST(MOC_Solver, Frozen2x2KernelMatchesGenericStepOnNonUniformGrid)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties());
+    vector<double>& x = pipe.profile.coordinates;
+    const double dx = x[1] - x[0];
+    for (size_t index = 1; index + 1 < x.size(); ++index) {
+        x[index] += 0.3 * dx * sin(static_cast<double>(index));
+    }
+    double dx_min = std::numeric_limits<double>::max();
+    for (size_t index = 1; index < x.size(); ++index) {
+        dx_min = std::min(dx_min, x[index] - x[index - 1]);
+    }
+
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+    size_t n = pipeModel.get_grid().size();
+
+    typedef composite_layer_t<profile_collection_t<2>, moc_solver<2>::specific_layer> composite_layer_type;
+    ring_buffer_t<composite_layer_type> generic_buffer(2, n);
+    profile_wrapper<double, 2> start_layer(get_profiles_pointers(generic_buffer.current().vars.point_double));
+    solve_euler_corrector<2>(pipeModel, -1, { 5e5, 400 }, &start_layer);
+    ring_buffer_t<profile_collection_t<2>> frozen_buffer(2, n);
+    frozen_buffer.current().point_double = generic_buffer.current().vars.point_double;
+    generic_buffer.advance(+1);
+    frozen_buffer.advance(+1);
+
+    moc_frozen_eigens_t<2> frozen(pipeModel);
+    // шаг меньше курантовского для самой короткой ячейки, чтобы характеристики попадали между узлами
+    double dt = 0.6 * dx_min / std::abs(frozen.eigenvals[0]);
+
+    moc_layer_wrapper<2> moc_current(generic_buffer.current().vars, std::get<0>(generic_buffer.current().specific));
+    moc_layer_wrapper<2> moc_previous(generic_buffer.previous().vars, std::get<0>(generic_buffer.previous().specific));
+    moc_solver<2, PipeModelPGConstArea> generic_solver(pipeModel, moc_previous, moc_current);
+    ASSERT_EQ(generic_solver.step_inner(dt), dt);
+
+    moc_solver<2, PipeModelPGConstArea> frozen_solver(pipeModel, frozen,
+        frozen_buffer.previous(), frozen_buffer.current());
+    ASSERT_EQ(frozen_solver.step_inner(dt), dt);
+
+    const auto& generic_result = generic_buffer.current().vars.point_double;
+    const auto& kernel_result = frozen_buffer.current().point_double;
+    for (size_t dimension = 0; dimension < 2; ++dimension) {
+        for (size_t index = 1; index < n - 1; ++index) {
+            ASSERT_NEAR(generic_result[dimension][index], kernel_result[dimension][index],
+                1e-12 * std::abs(generic_result[dimension][index]));
+        }
+    }
+}
+
+/// @brief Многошаговый расчет гидроудара через run (полный и замороженный режимы)
+/// совпадает с расчетом с пересозданием солвера на каждом шаге
+TEST(MOC_Solver, MultiStepRunMatchesPerStepSolvers)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties());
+    oil_parameters_t oil;
+    PipeModelPGConstArea pipeModel(pipe, oil);
+    size_t n = pipeModel.get_grid().size();
+
+    constexpr size_t step_count = 100;
+    double duration;
+    auto expected = moc_waterhammer_benchmark<moc_solver<2>>(pipeModel, step_count, &duration);
+
+    double G = 400;
+    double Pout = 5e5;
+    auto boundaries = [&](size_t step_index) {
+        return std::make_pair(pipeModel.const_mass_flow_equation(G + 50),
+            pipeModel.const_pressure_equation(Pout));
+    };
+
+    typedef composite_layer_t<profile_collection_t<2>, moc_solver<2>::specific_layer> composite_layer_type;
+    ring_buffer_t<composite_layer_type> buffer(2, n);
+    profile_wrapper<double, 2> start_layer(get_profiles_pointers(buffer.current().vars.point_double));
+    solve_euler_corrector<2>(pipeModel, -1, { Pout, G }, &start_layer);
+
+    size_t observed_steps = 0;
+    moc_solver<2>::run(pipeModel, buffer, step_count, std::numeric_limits<double>::quiet_NaN(),
+        boundaries,
+        [&](size_t step_index, double time_step, const composite_layer_type& layer) {
+            observed_steps++;
+        });
+    ASSERT_EQ(observed_steps, step_count);
+    ASSERT_EQ(expected, buffer.current().vars.point_double);
+
+    ring_buffer_t<profile_collection_t<2>> frozen_buffer(3, n);
+    profile_wrapper<double, 2> frozen_start_layer(get_profiles_pointers(frozen_buffer.current().point_double));
+    solve_euler_corrector<2>(pipeModel, -1, { Pout, G }, &frozen_start_layer);
+
+    moc_frozen_eigens_t<2> frozen(pipeModel);
+    double time = moc_solver<2, PipeModelPGConstArea>::run(pipeModel, frozen, frozen_buffer,
+        step_count, std::numeric_limits<double>::quiet_NaN(), boundaries);
+    ASSERT_NEAR(time, step_count * frozen.courant_step, 1e-9 * time);
+    for (size_t dimension = 0; dimension < 2; ++dimension) {
+        for (size_t index = 0; index < n; ++index) {
+            ASSERT_NEAR(expected[dimension][index], frozen_buffer.current().point_double[dimension][index],
+                1e-12 * std::abs(expected[dimension][index]));
+        }
+    }
+}
@@ -0,0 +1,253 @@
+﻿#pragma once
+
+
+/// @brief Профили слоя лежат в одном блоке памяти, выровнены по 64 байта
+/// и дополнены нулями до кратного выравниванию размера
+TEST(ArenaProfileCollection, ProfilesAreAlignedAndPadded)
+{
+    typedef arena_profile_collection_t<2, 1> layer_t;
+    size_t point_count = 11;
+    layer_t layer(point_count);
+
+    ASSERT_EQ(layer.point_double[0].size(), point_count);
+    ASSERT_EQ(layer.cell_double[0].size(), point_count - 1);
+    for (const layer_t::profile_type* profile : { &layer.point_double[0], &layer.point_double[1], &layer.cell_double[0] }) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(profile->data()) % layer_t::arena_alignment, 0u);
+        ASSERT_EQ(profile->padded_size() * sizeof(double) % layer_t::arena_alignment, 0u);
+        ASSERT_GE(profile->padded_size(), profile->size());
+        for (size_t index = profile->size(); index < profile->padded_size(); ++index) {
+            ASSERT_EQ(profile->data()[index], 0.0);
+        }
+    }
+    // профили идут в памяти подряд
+    ASSERT_EQ(layer.point_double[1].data(), layer.point_double[0].data() + layer.point_double[0].padded_size());
+    ASSERT_EQ(layer.cell_double[0].data(), layer.point_double[1].data() + layer.point_double[1].padded_size());
+
+    // перемещение слоя не меняет адреса профилей, исходный слой отвязывается
+    const double* cell_data = layer.cell_double[0].data();
+    layer_t moved(std::move(layer));
+    ASSERT_EQ(moved.cell_double[0].data(), cell_data);
+    ASSERT_EQ(moved.cell_double[0].size(), point_count - 1);
+    ASSERT_EQ(layer.cell_double[0].data(), nullptr);
+    ASSERT_TRUE(layer.cell_double[0].empty());
+    static_assert(!std::is_copy_constructible<layer_t::profile_type>::value, 
+        "profile view copy would share memory while assignment copies values");
+}
+
+/// @brief Слои в буфере имеют собственную память, копирование слоя копирует значения;
+/// обертка profile_wrapper над представлениями профилей интерполирует так же, как над vector
+TEST(ArenaProfileCollection, WorksWithRingBufferAndProfileWrapper)
+{
+    typedef arena_profile_collection_t<2> layer_t;
+    size_t point_count = 5;
+    ring_buffer_t<layer_t> buffer(2, point_count);
+
+    layer_t& prev = buffer.previous();
+    prev.point_double[0] = vector<double>{ 1, 2, 3, 4, 5 };
+    prev.point_double[1] = vector<double>{ 10, 20, 30, 40, 50 };
+    buffer.current() = prev;
+    ASSERT_NE(buffer.current().point_double[0].data(), prev.point_double[0].data());
+    ASSERT_EQ(buffer.current().point_double[1].to_vector(), prev.point_double[1].to_vector());
+
+    array<vector<double>, 2> vector_profiles{ prev.point_double[0].to_vector(), prev.point_double[1].to_vector() };
+    profile_wrapper<double, 2> vector_wrapper(get_profiles_pointers(vector_profiles));
+    profile_wrapper<double, 2, profile_span_t<double>> span_wrapper(get_profiles_pointers(prev.point_double));
+
+    ASSERT_EQ(span_wrapper.size(), point_count);
+    for (double offset : { -0.5, 0.0, 0.25 }) {
+        auto expected = vector_wrapper.interpolate(2, offset);
+        auto actual = span_wrapper.interpolate(2, offset);
+        ASSERT_EQ(expected, actual);
+    }
+    span_wrapper(1, 3) = 45;
+    ASSERT_EQ(prev.point_double[1][3], 45);
+}
+
+/// @brief Слой после перемещения пуст (point_count = 0): его копирование и присваивание
+/// дают пустые профили, а присваивание в него снова выделяет память
+TEST(ArenaProfileCollection, CopiesMovedFromLayer)
+{
+    typedef arena_profile_collection_t<1, 1> layer_t;
+    layer_t layer(4);
+    layer.cell_double[0] = vector<double>{ 1, 2, 3 };
+    layer_t moved(std::move(layer));
+
+    layer_t copy(layer);
+    ASSERT_TRUE(copy.point_double[0].empty());
+    ASSERT_TRUE(copy.cell_double[0].empty());
+
+    layer_t assigned(4);
+    assigned = layer;
+    ASSERT_TRUE(assigned.point_double[0].empty());
+    ASSERT_TRUE(assigned.cell_double[0].empty());
+
+    layer = moved;
+    ASSERT_EQ(layer.cell_double[0].to_vector(), moved.cell_double[0].to_vector());
+    ASSERT_NE(layer.cell_double[0].data(), moved.cell_double[0].data());
+}
+
+/// @brief Представление буфера применяет селектор при каждом обращении,
+/// делит индекс текущего слоя с исходным буфером, а солвер через представление 
+/// считает так же, как через буфер оберток
+TEST(RingBufferView, SharesCurrentLayerWithParentBuffer)
+{
+    struct two_profile_layer_t {
+        vector<double> density;
+        vector<double> viscosity;
+        quickest_ultimate_fv_solver_traits<1>::specific_layer specific;
+        two_profile_layer_t(size_t point_count)
+            : density(point_count - 1, 850)
+            , viscosity(point_count - 1, 15e-6)
+            , specific(point_count)
+        {}
+        static quickest_ultimate_fv_wrapper<1> get_density_wrapper(two_profile_layer_t& layer) {
+            return quickest_ultimate_fv_wrapper<1>(layer.density, layer.specific);
+        }
+    };
+
+    simple_pipe_properties simple_pipe = simple_pipe_properties::sample_district();
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    vector<double> Q(pipe.profile.getPointCount(), 0.5);
+    PipeQAdvection advection_model(pipe, Q);
+    const auto& x = advection_model.get_grid();
+    double dt = 0.8 * (x[1] - x[0]) / advection_model.getEquationsCoeffs(0, 0); // Cr = 0.8
+
+    ring_buffer_t<two_profile_layer_t> buffer(3, pipe.profile.getPointCount());
+    ring_buffer_t<two_profile_layer_t> wrapper_source(buffer);
+    auto view = buffer.get_buffer_view(&two_profile_layer_t::get_density_wrapper);
+
+    ASSERT_EQ(&view.current().vars, &buffer.current().density);
+    ASSERT_EQ(&view.previous().vars, &buffer.previous().density);
+    ASSERT_EQ(&view[1].vars, &buffer[1].density);
+    view.advance(+1);
+    ASSERT_EQ(&view.current().vars, &buffer.current().density); // сдвиг виден в исходном буфере
+    wrapper_source.advance(+1);
+
+    for (size_t index = 0; index < 10; ++index) {
+        quickest_ultimate_fv_solver view_solver(advection_model, view);
+        view_solver.step(dt, 860, 870);
+        view.advance(+1);
+
+        auto wrapper = wrapper_source.get_buffer_wrapper(&two_profile_layer_t::get_density_wrapper);
+        quickest_ultimate_fv_solver wrapper_solver(advection_model, wrapper);
+        wrapper_solver.step(dt, 860, 870);
+        wrapper_source.advance(+1);
+    }
+    ASSERT_EQ(buffer.previous().density, wrapper_source.previous().density);
+    ASSERT_GT(buffer.previous().density.front(), 850);
+}
+
+/// @brief Точка восстановления сохраняет все слои буфера (включая векторные и специфические профили),
+/// индекс текущего слоя и курсор временных рядов
+TEST(Checkpoint, RestoresBufferAndTimeseriesCursor)
+{
+    typedef profile_collection_t<1, 1, 1, 2, 1, 2> var_layer_t;
+    typedef composite_layer_t<var_layer_t, profile_collection_t<2>> layer_t;
+    size_t point_count = 100;
+
+    ring_buffer_t<layer_t> buffer(3, point_count);
+    for (size_t layer_index = 0; layer_index < 3; ++layer_index) {
+        layer_t& layer = buffer[static_cast<int>(layer_index)];
+        for (size_t index = 0; index < point_count; ++index) {
+            layer.vars.point_double[0][index] = layer_index + 0.5 * index;
+            layer.vars.point_vector[0][index] = { 1.0 * index, -1.0 * layer_index };
+            std::get<0>(layer.specific).point_double[1][index] = layer_index * 1e-3 * index;
+        }
+        layer.vars.cell_double[0][point_count / 2] = 1.0 / (layer_index + 1);
+    }
+    buffer.advance(+2);
+
+    vector<time_t> times{ 0, 60, 120, 180 };
+    vector_timeseries_t timeseries({ { times, { 1, 2, 3, 4 } }, { times, { 10, 20, 30, 40 } } });
+    timeseries(130);
+
+    std::string filename = (std::filesystem::temp_directory_path() / "pde_solvers_checkpoint.bin").string();
+    save_checkpoint(filename, buffer, &timeseries.get_cursor());
+
+    ring_buffer_t<layer_t> restored(3, 2);
+    vector_timeseries_t restored_timeseries({ { times, { 1, 2, 3, 4 } }, { times, { 10, 20, 30, 40 } } });
+    vector<size_t> cursor;
+    load_checkpoint(filename, &restored, &cursor);
+    restored_timeseries.set_cursor(cursor);
+    std::filesystem::remove(filename);
+
+    ASSERT_EQ(restored.get_current_layer_index(), buffer.get_current_layer_index());
+    for (int offset = 0; offset < 3; ++offset) {
+        ASSERT_EQ(restored[offset].vars.point_double, buffer[offset].vars.point_double);
+        ASSERT_EQ(restored[offset].vars.cell_double, buffer[offset].vars.cell_double);
+        ASSERT_EQ(restored[offset].vars.point_vector, buffer[offset].vars.point_vector);
+        ASSERT_EQ(restored[offset].vars.cell_vector, buffer[offset].vars.cell_vector);
+        ASSERT_EQ(std::get<0>(restored[offset].specific).point_double, std::get<0>(buffer[offset].specific).point_double);
+    }
+    ASSERT_EQ(restored_timeseries.get_cursor(), timeseries.get_cursor());
+    ASSERT_EQ(restored_timeseries(150), timeseries(150));
+    ASSERT_THROW(restored_timeseries(30), std::logic_error); // курсор уже за этим моментом
+}
+
+/// @brief Сжатая история слоев при переносе партий: без потерь восстанавливает любой шаг 
+/// и ряд значений в точке точно, с заданной ошибкой - не хуже ошибки; обе занимают меньше исходных данных
+TEST(LayerHistory, RestoresStepsAndPointSeries)
+{
+    typedef layer_history_t<1, 1> history_t;
+    size_t point_count = 1000;
+    size_t step_count = 200;
+
+    // профиль партий сдвигается на точку за шаг, вязкость меняется всюду понемногу
+    history_t::layer_type layer(point_count);
+    vector<history_t::layer_type> layers;
+    history_t lossless(point_count);
+    // допустимая ошибка задается для каждого профиля в его масштабе
+    double density_tolerance = 1e-3;
+    double viscosity_tolerance = 1e-9;
+    history_t lossy(point_count, { density_tolerance }, { viscosity_tolerance });
+    for (size_t step = 0; step < step_count; ++step) {
+        for (size_t point = 0; point < point_count; ++point) {
+            layer.point_double[0][point] = ((point + point_count - step) / 150) % 2 == 0 ? 850.5 : 860.25;
+        }
+        for (size_t cell = 0; cell < point_count - 1; ++cell) {
+            layer.cell_double[0][cell] = 1e-5 * (1 + 0.3 * std::sin(0.01 * cell + 0.05 * step));
+        }
+        layers.push_back(layer);
+        lossless.push_back(layer);
+        lossy.push_back(layer);
+    }
+    ASSERT_EQ(lossless.size(), step_count);
+
+    size_t raw_bytes = step_count * (2 * point_count - 1) * sizeof(double);
+    ASSERT_LT(lossless.get_compressed_bytes(), raw_bytes);
+    ASSERT_LT(lossy.get_compressed_bytes(), lossless.get_compressed_bytes());
+
+    history_t::layer_type restored(point_count);
+    for (size_t step = 0; step < step_count; ++step) {
+        lossless.get_layer(step, &restored);
+        ASSERT_EQ(restored.point_double[0], layers[step].point_double[0]);
+        ASSERT_EQ(restored.cell_double[0], layers[step].cell_double[0]);
+
+        lossy.get_layer(step, &restored);
+        for (size_t point = 0; point < point_count; ++point) {
+            ASSERT_NEAR(restored.point_double[0][point], layers[step].point_double[0][point], density_tolerance);
+        }
+        for (size_t cell = 0; cell < point_count - 1; ++cell) {
+            ASSERT_NEAR(restored.cell_double[0][cell], layers[step].cell_double[0][cell], viscosity_tolerance);
+        }
+    }
+
+    // значение вне диапазона квантования не записывается, история не меняется
+    layer.point_double[0][10] = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_THROW(lossy.push_back(layer), std::runtime_error);
+    layer.point_double[0][10] = 1e300;
+    ASSERT_THROW(lossy.push_back(layer), std::runtime_error);
+    layer.point_double[0][10] = 850.5;
+    layer.cell_double[0][10] = 1e300;
+    ASSERT_THROW(lossy.push_back(layer), std::runtime_error);
+    ASSERT_EQ(lossy.size(), step_count);
+    ASSERT_EQ(lossy.get_point_history(0).size(), step_count);
+
+    for (size_t point : { 0, 63, 64, 500, 999 }) {
+        vector<double> series = lossless.get_point_history(0).get_point_series(point, 20, 120);
+        ASSERT_EQ(series.size(), 100u);
+        for (size_t step = 20; step < 120; ++step) {
+            ASSERT_EQ(series[step - 20], layers[step].point_double[0][point]);
+        }
+    }
+}
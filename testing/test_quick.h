@@ -174,6 +174,39 @@ TEST_F(UpstreamDifferencing, CanConsiderFlowSwap) {
     ASSERT_NEAR(rho_curr.front(), rho_prev.front(), 1e-8); // плотность в начале не изменилась
 }
 
+/// @brief Upstream differencing берет скорость на каждой границе ячейки, 
+/// поэтому при переменном по трубе расходе поток через границу - это расход на границе, 
+/// умноженный на значение в донорской ячейке
+TEST_F(UpstreamDifferencing, UsesFaceVelocityForVariableFlow) {
+    for (size_t index = 0; index < Q.size(); ++index) {
+        Q[index] = 0.5 + 0.01 * index;
+    }
+    layer_t& prev = buffer->previous();
+    layer_t& next = buffer->current();
+    vector<double>& rho_prev = prev.vars.cell_double[0];
+    for (size_t cell = 0; cell < rho_prev.size(); ++cell) {
+        rho_prev[cell] = 850 + 0.1 * cell;
+    }
+
+    double rho_in = 860;
+    double rho_out = 870;
+    double dt = 60; // 1 минута
+
+    upstream_fv_solver solver(*advection_model, prev, next);
+    solver.step(dt, rho_in, rho_out);
+
+    const vector<double>& x = pipe.profile.coordinates;
+    double S = pipe.wall.getArea();
+    const vector<double>& F = std::get<0>(next.specific).point_double[0];
+    const vector<double>& rho_curr = next.vars.cell_double[0];
+    ASSERT_NEAR(F[0], rho_in * Q[0] / S, 1e-9);
+    for (size_t cell = 0; cell < rho_prev.size(); ++cell) {
+        ASSERT_NEAR(F[cell + 1], rho_prev[cell] * Q[cell + 1] / S, 1e-9);
+        double expected = rho_prev[cell] + dt / (x[cell + 1] - x[cell]) * (F[cell] - F[cell + 1]);
+        ASSERT_NEAR(rho_curr[cell], expected, 1e-9);
+    }
+}
+
 /// @brief Разработка метода прямых разностей по [Leonard 1979]
 TEST_F(UpstreamDifferencing, UseCaseSingleStep)
 {
@@ -494,7 +527,7 @@ TEST_F(QUICKEST_ULTIMATE, CanConsiderFlowSwap) {
 
     double rho_in = 860;
     double rho_out = 870;
-    double dt = 60; // 1 минута
+    double dt = 30; // Cr = 0.72 (при dt = 60 число Куранта больше 1)
 
     quickest_ultimate_fv_solver solver(*advection_model, prev, next);
     solver.step(dt, rho_in, rho_out);
@@ -504,3 +537,432 @@ TEST_F(QUICKEST_ULTIMATE, CanConsiderFlowSwap) {
     ASSERT_GT(rho_curr.back(), rho_prev.back()); // плотность в конце выросла
     ASSERT_NEAR(rho_curr.front(), rho_prev.front(), 1e-8); // плотность в начале не изменилась
 }
+
+/// @brief Проверка числа Куранта QUICKEST-ULTIMATE учитывает модуль скорости при обратном потоке
+TEST_F(QUICKEST_ULTIMATE, ChecksCourantForReverseFlow) {
+    Q = vector<double>(pipe.profile.getPointCount(), -0.5);
+
+    layer_t& prev = buffer->previous();
+    layer_t& next = buffer->current();
+
+    double dx = pipe.profile.coordinates[1] - pipe.profile.coordinates[0];
+    double v = 0.5 / pipe.wall.getArea();
+    double dt = 2 * dx / v; // Cr = 2
+
+    quickest_ultimate_fv_solver solver(*advection_model, prev, next);
+    ASSERT_THROW(solver.step(dt, 860, 870), std::runtime_error);
+}
+
+/// @brief Многошаговый расчет QUICKEST-ULTIMATE через run совпадает 
+/// с расчетом с пересозданием солвера на каждом шаге
+TEST_F(QUICKEST_ULTIMATE, MultiStepRunMatchesPerStepSolvers)
+{
+    double rho_in = 860;
+    double rho_out = 870;
+    const auto& x = advection_model->get_grid();
+    double dt = 0.8 * (x[1] - x[0]) / advection_model->getEquationsCoeffs(0, 0); // Cr = 0.8
+    size_t step_count = 200;
+
+    ring_buffer_t<layer_t> run_buffer(*buffer);
+    run_buffer.advance(-1); // начальные условия в текущем слое
+
+    for (size_t index = 0; index < step_count; ++index) {
+        quickest_ultimate_fv_solver solver(*advection_model, *buffer);
+        solver.step(dt, rho_in + index % 7, rho_out);
+        buffer->advance(+1);
+    }
+
+    size_t observed_steps = 0;
+    double time = quickest_ultimate_fv_solver::run(*advection_model, run_buffer, step_count, dt,
+        [&](size_t step_index) { return std::make_pair(rho_in + step_index % 7, rho_out); },
+        [&](size_t step_index, double time_step, const layer_t& layer) { observed_steps++; });
+
+    ASSERT_EQ(observed_steps, step_count);
+    ASSERT_NEAR(time, step_count * dt, 1e-9);
+    ASSERT_EQ(buffer->previous().vars.cell_double[0], run_buffer.current().vars.cell_double[0]);
+}
+
+/// @brief Однопроходный шаг без специфического слоя совпадает с шагом с сохранением потоков
+/// для прямого и обратного направления потока
+TEST_F(QUICKEST_ULTIMATE, FusedStepMatchesStepWithFluxLayer)
+{
+    double rho_in = 860;
+    double rho_out = 870;
+    const auto& x = advection_model->get_grid();
+
+    for (double flow : { 0.5, -0.5 }) {
+        Q = vector<double>(pipe.profile.getPointCount(), flow);
+        double dt = 0.8 * (x[1] - x[0]) / std::abs(advection_model->getEquationsCoeffs(0, 0)); // Cr = 0.8
+
+        ring_buffer_t<vector<double>> fused_buffer(2, buffer->previous().vars.cell_double[0]);
+        vector<double> flux(pipe.profile.getPointCount());
+        for (size_t index = 0; index < 100; ++index) {
+            quickest_ultimate_fv_solver solver(*advection_model, *buffer);
+            solver.step(dt, rho_in + index % 7, rho_out - index % 5);
+            buffer->advance(+1);
+
+            quickest_ultimate_fv_solver fused_solver(*advection_model, fused_buffer);
+            fused_solver.step_fused(dt, rho_in + index % 7, rho_out - index % 5,
+                index + 1 == 100 ? &flux : nullptr);
+            fused_buffer.advance(+1);
+        }
+        ASSERT_EQ(buffer->previous().vars.cell_double[0], fused_buffer.previous());
+        ASSERT_EQ(std::get<0>(buffer->previous().specific).point_double[0], flux);
+    }
+}
+
+/// @brief Шаг с заданными скоростями на границах при постоянном по трубе расходе 
+/// совпадает с однопроходным шагом для прямого и обратного потока
+TEST_F(QUICKEST_ULTIMATE, VariableVelocityStepMatchesFusedStepForUniformFlow)
+{
+    double rho_in = 860;
+    double rho_out = 870;
+    const auto& x = advection_model->get_grid();
+
+    for (double flow : { 0.5, -0.5 }) {
+        Q = vector<double>(pipe.profile.getPointCount(), flow);
+        double dt = 0.8 * (x[1] - x[0]) / std::abs(advection_model->getEquationsCoeffs(0, 0)); // Cr = 0.8
+
+        ring_buffer_t<vector<double>> fused_buffer(2, buffer->previous().vars.cell_double[0]);
+        ring_buffer_t<vector<double>> face_velocity_buffer(fused_buffer);
+        vector<double> fused_flux(pipe.profile.getPointCount());
+        vector<double> face_velocity_flux(pipe.profile.getPointCount());
+        vector<double> face_velocity;
+        for (size_t index = 0; index < 100; ++index) {
+            quickest_ultimate_fv_solver fused_solver(*advection_model, fused_buffer);
+            fused_solver.step_fused(dt, rho_in + index % 7, rho_out - index % 5, &fused_flux);
+            fused_buffer.advance(+1);
+
+            advection_model->calc_face_velocities(&face_velocity);
+            quickest_ultimate_fv_solver solver(*advection_model, face_velocity_buffer);
+            solver.step_variable_velocity(dt, face_velocity, rho_in + index % 7, rho_out - index % 5,
+                &face_velocity_flux);
+            face_velocity_buffer.advance(+1);
+        }
+        ASSERT_EQ(fused_buffer.previous(), face_velocity_buffer.previous());
+        ASSERT_EQ(fused_flux, face_velocity_flux);
+    }
+}
+
+/// @brief При смене направления потока внутри трубы (потоки сходятся к середине)
+/// масса сохраняется: ее изменение определяется только потоками на концах трубы
+TEST_F(QUICKEST_ULTIMATE, VariableVelocityStepConservesMassForConvergingFlow)
+{
+    size_t point_count = pipe.profile.getPointCount();
+    for (size_t index = 0; index < point_count; ++index) {
+        Q[index] = index < point_count / 2 ? 0.5 : -0.3;
+    }
+    const auto& x = advection_model->get_grid();
+    double dt = 0.8 * (x[1] - x[0]) / advection_model->getEquationsCoeffs(0, 0); // Cr = 0.8 на входе
+
+    vector<double> face_velocity;
+    advection_model->calc_face_velocities(&face_velocity);
+
+    ring_buffer_t<vector<double>> rho_buffer(2, buffer->previous().vars.cell_double[0]);
+    vector<double> flux(point_count);
+    auto calc_mass = [&](const vector<double>& rho) {
+        double mass = 0;
+        for (size_t cell = 0; cell < rho.size(); ++cell) {
+            mass += rho[cell] * (x[cell + 1] - x[cell]);
+        }
+        return mass;
+    };
+    for (size_t index = 0; index < 100; ++index) {
+        double mass_prev = calc_mass(rho_buffer.previous());
+        quickest_ultimate_fv_solver solver(*advection_model, rho_buffer);
+        solver.step_variable_velocity(dt, face_velocity, 860, 870, &flux);
+        double mass_curr = calc_mass(rho_buffer.current());
+        ASSERT_NEAR(mass_curr - mass_prev, dt * (flux.front() - flux.back()), 1e-6 * mass_prev);
+        rho_buffer.advance(+1);
+    }
+    const vector<double>& rho = rho_buffer.previous();
+    ASSERT_GT(rho.front(), 850); // с обоих концов втекает более тяжелая нефть
+    ASSERT_GT(rho.back(), 850);
+}
+
+/// @brief Внешний шаг с Cr = 2.5 дробится на подшаги с Cr <= 0.9 и совпадает 
+/// с ручным расчетом теми же подшагами; при малом расходе дробления нет
+TEST_F(QUICKEST_ULTIMATE, SubcyclingSplitsStepByTargetCourant)
+{
+    double rho_in = 860;
+    double rho_out = 870;
+    const auto& x = advection_model->get_grid();
+    double dt = 2.5 * (x[1] - x[0]) / advection_model->getEquationsCoeffs(0, 0); // Cr = 2.5
+
+    quickest_ultimate_fv_subcycling_solver subcycling_solver(*advection_model, 0.9);
+    ring_buffer_t<vector<double>> subcycling_buffer(2, buffer->previous().vars.cell_double[0]);
+    ring_buffer_t<vector<double>> manual_buffer(subcycling_buffer);
+    for (size_t index = 0; index < 20; ++index) {
+        size_t substep_count = subcycling_solver.step(dt, subcycling_buffer, rho_in, rho_out);
+        subcycling_buffer.advance(+1);
+        ASSERT_EQ(substep_count, 3u);
+
+        for (size_t substep = 0; substep < 3; ++substep) {
+            quickest_ultimate_fv_solver solver(*advection_model, manual_buffer);
+            solver.step_fused(dt / 3, rho_in, rho_out);
+            manual_buffer.advance(+1);
+        }
+    }
+    ASSERT_EQ(subcycling_buffer.previous(), manual_buffer.previous());
+
+    // Скорости на границах через PipeQAdvection::calc_face_velocities, слои - массивы
+    fv_subcycling_solver_t<fv_quickest_ultimate_face_t, double, PipeQAdvection> 
+        face_velocity_solver(*advection_model, 0.9);
+    const vector<double>& rho_initial = buffer->previous().vars.cell_double[0];
+    std::array<vector<double>, 2> layers{ rho_initial, rho_initial };
+    for (size_t index = 0; index < 20; ++index) {
+        ASSERT_EQ(face_velocity_solver.step(dt, layers[index % 2], layers[(index + 1) % 2], rho_in, rho_out), 3u);
+    }
+    ASSERT_EQ(layers[0], manual_buffer.previous());
+
+    Q = vector<double>(pipe.profile.getPointCount(), 0.05); // Cr = 0.25
+    ASSERT_EQ(subcycling_solver.step(dt, subcycling_buffer, rho_in, rho_out), 1u);
+}
+
+/// @brief Солвер с дроблением шага работает с профилями слоев в общем блоке памяти 
+/// (arena_profile_collection_t) и дает тот же результат, что и с vector
+TEST_F(QUICKEST_ULTIMATE, SubcyclingSolverStepsArenaLayers)
+{
+    double rho_in = 860;
+    double rho_out = 870;
+    const auto& x = advection_model->get_grid();
+    double dt = 2.5 * (x[1] - x[0]) / advection_model->getEquationsCoeffs(0, 0); // Cr = 2.5
+
+    quickest_ultimate_fv_subcycling_solver solver(*advection_model, 0.9);
+    const vector<double>& rho_initial = buffer->previous().vars.cell_double[0];
+    ring_buffer_t<vector<double>> vector_buffer(2, rho_initial);
+    ring_buffer_t<arena_profile_collection_t<0, 1>> arena_buffer(2, pipe.profile.getPointCount());
+    arena_buffer.previous().cell_double[0] = rho_initial;
+    for (size_t index = 0; index < 20; ++index) {
+        solver.step(dt, vector_buffer, rho_in, rho_out);
+        vector_buffer.advance(+1);
+        solver.step(dt, arena_buffer.previous().cell_double[0], arena_buffer.current().cell_double[0], 
+            rho_in, rho_out);
+        arena_buffer.advance(+1);
+    }
+    ASSERT_EQ(arena_buffer.previous().cell_double[0].to_vector(), vector_buffer.previous());
+}
+
+/// @brief Хранение плотности в float (потоки в double) при прохождении партий 
+/// отличается от расчета в double не более чем на ошибку округления float
+TEST_F(QUICKEST_ULTIMATE, FloatStorageMatchesDoubleStorage)
+{
+    typedef fv_solver_t<fv_quickest_ultimate_face_t, float> float_solver_t;
+    typedef composite_layer_t<float_solver_t::var_layer_data, float_solver_t::specific_layer> float_layer_t;
+    static_assert(std::is_same<float_solver_t::var_layer_data::scalar_type, float>::value, "");
+
+    const auto& x = advection_model->get_grid();
+    double dt = 0.8 * (x[1] - x[0]) / advection_model->getEquationsCoeffs(0, 0); // Cr = 0.8
+    size_t step_count = 2000;
+    auto boundaries = [](size_t step_index) {
+        double rho_in = (step_index / 300) % 2 == 0 ? 860 : 840; // чередование партий
+        return std::make_pair(rho_in, 870.0);
+    };
+
+    ring_buffer_t<float_layer_t> float_buffer(2, pipe.profile.getPointCount());
+    float_buffer.current().vars.cell_scalar()[0] = vector<float>(pipe.profile.getPointCount() - 1, 850.0f);
+    buffer->advance(-1); // начальные условия в текущем слое
+
+    float_solver_t::run(*advection_model, float_buffer, step_count, dt, boundaries);
+    quickest_ultimate_fv_solver::run(*advection_model, *buffer, step_count, dt, boundaries);
+
+    const vector<float>& rho_float = float_buffer.current().vars.cell_scalar()[0];
+    const vector<double>& rho_double = buffer->current().vars.cell_double[0];
+    double max_error = 0;
+    for (size_t cell = 0; cell < rho_double.size(); ++cell) {
+        max_error = std::max(max_error, std::abs(rho_float[cell] - rho_double[cell]));
+    }
+    ASSERT_LT(max_error, 1e-2);
+}
+
+/// @brief Перенос нескольких параметров за один проход совпадает 
+/// с расчетом каждого параметра отдельным солвером для прямого и обратного потока
+TEST_F(QUICKEST_ULTIMATE, MulticomponentMatchesSeparateSolvers)
+{
+    typedef quickest_ultimate_fv_multicomponent_solver<3> multicomponent_solver;
+    const multicomponent_solver::component_values_t initial{ 850, 15e-6, 0.01 };
+    const multicomponent_solver::component_values_t u_in{ 860, 20e-6, 0.02 };
+    const multicomponent_solver::component_values_t u_out{ 870, 10e-6, 0.005 };
+    const auto& x = advection_model->get_grid();
+    size_t cell_count = pipe.profile.getPointCount() - 1;
+
+    for (double flow : { 0.5, -0.5 }) {
+        Q = vector<double>(pipe.profile.getPointCount(), flow);
+        double dt = 0.8 * (x[1] - x[0]) / std::abs(advection_model->getEquationsCoeffs(0, 0)); // Cr = 0.8
+
+        ring_buffer_t<multicomponent_solver::profile_type> multicomponent_buffer(2,
+            multicomponent_solver::profile_type(cell_count, initial));
+        for (size_t index = 0; index < 100; ++index) {
+            multicomponent_solver solver(*advection_model, multicomponent_buffer);
+            solver.step(dt, u_in, u_out);
+            multicomponent_buffer.advance(+1);
+        }
+
+        for (size_t component = 0; component < initial.size(); ++component) {
+            ring_buffer_t<vector<double>> component_buffer(2, vector<double>(cell_count, initial[component]));
+            for (size_t index = 0; index < 100; ++index) {
+                quickest_ultimate_fv_solver solver(*advection_model, component_buffer);
+                solver.step_fused(dt, u_in[component], u_out[component]);
+                component_buffer.advance(+1);
+            }
+            const auto& expected = component_buffer.previous();
+            const auto& actual = multicomponent_buffer.previous();
+            for (size_t cell = 0; cell < cell_count; ++cell) {
+                ASSERT_EQ(expected[cell], actual[cell][component]);
+            }
+        }
+    }
+}
+
+/// @brief Ансамбль сценариев QUICKEST-ULTIMATE (разные расходы, в т.ч. обратные, 
+/// и разные граничные условия) совпадает с расчетом каждого сценария отдельным солвером
+TEST_F(QUICKEST_ULTIMATE, EnsembleMatchesSeparateSolvers)
+{
+    typedef quickest_ultimate_fv_ensemble_solver::layer_type ensemble_layer_t;
+
+    const vector<double> flows{ 0.5, 0.1, -0.3, 0.45, -0.05, 0.2 };
+    const size_t K = flows.size();
+    const auto& grid = advection_model->get_grid();
+    size_t n = grid.size();
+    double dt = 0.9 * (grid[1] - grid[0]) / (0.5 / pipe.wall.getArea());
+    constexpr size_t step_count = 50;
+
+    vector<double> velocity(K);
+    vector<double> u_in(K), u_out(K);
+    ring_buffer_t<ensemble_layer_t> ensemble_buffer(2, ensemble_layer_t(n, K));
+    for (size_t k = 0; k < K; ++k) {
+        Q = vector<double>(n, flows[k]);
+        velocity[k] = advection_model->getEquationsCoeffs(0, 0);
+        u_in[k] = 860 + k;
+        u_out[k] = 840 - k;
+
+        vector<double> rho_initial(n - 1);
+        for (size_t cell = 0; cell < n - 1; ++cell) {
+            rho_initial[cell] = 850 + 3 * sin(0.01 * cell + k);
+        }
+        ensemble_buffer.previous().vars.cell_double[0].set_scenario_profile(k, rho_initial);
+    }
+
+    for (size_t step = 0; step < step_count; ++step) {
+        quickest_ultimate_fv_ensemble_solver solver(grid, velocity, ensemble_buffer);
+        solver.step(dt, u_in, u_out);
+        ensemble_buffer.advance(+1);
+    }
+
+    for (size_t k = 0; k < K; ++k) {
+        Q = vector<double>(n, flows[k]);
+        ring_buffer_t<layer_t> scenario_buffer(2, n);
+        for (size_t cell = 0; cell < n - 1; ++cell) {
+            scenario_buffer.previous().vars.cell_double[0][cell] = 850 + 3 * sin(0.01 * cell + k);
+        }
+        for (size_t step = 0; step < step_count; ++step) {
+            quickest_ultimate_fv_solver solver(*advection_model, scenario_buffer);
+            solver.step(dt, u_in[k], u_out[k]);
+            scenario_buffer.advance(+1);
+        }
+        ASSERT_EQ(scenario_buffer.previous().vars.cell_double[0],
+            ensemble_buffer.previous().vars.cell_double[0].get_scenario_profile(k));
+    }
+
+    // выход трубы по всем сценариям
+    vector<double> outlet = ensemble_buffer.previous().vars.cell_double[0].get_point_values(n - 2);
+    ASSERT_EQ(outlet.size(), K);
+}
+
+/// @brief Ансамбль с политикой ван Леера совпадает с отдельными солверами при обоих направлениях потока,
+/// а число Куранта проверяется по модулю скорости каждого сценария
+TEST_F(QUICKEST_ULTIMATE, EnsembleUsesFacePolicyAndChecksCourantPerScenario)
+{
+    typedef fv_ensemble_solver_t<fv_van_leer_face_t> ensemble_solver_t;
+    typedef ensemble_solver_t::layer_type ensemble_layer_t;
+
+    const vector<double> flows{ 0.4, -0.4 };
+    const size_t K = flows.size();
+    const auto& grid = advection_model->get_grid();
+    size_t n = grid.size();
+    double dt = 0.9 * (grid[1] - grid[0]) / (0.5 / pipe.wall.getArea());
+    constexpr size_t step_count = 20;
+
+    vector<double> velocity(K);
+    vector<double> u_in{ 860, 860 };
+    vector<double> u_out{ 840, 840 };
+    ring_buffer_t<ensemble_layer_t> ensemble_buffer(2, ensemble_layer_t(n, K));
+    vector<double> rho_initial(n - 1);
+    for (size_t cell = 0; cell < n - 1; ++cell) {
+        rho_initial[cell] = cell < (n - 1) / 2 ? 850 : 855;
+    }
+    for (size_t k = 0; k < K; ++k) {
+        Q = vector<double>(n, flows[k]);
+        velocity[k] = advection_model->getEquationsCoeffs(0, 0);
+        ensemble_buffer.previous().vars.cell_double[0].set_scenario_profile(k, rho_initial);
+    }
+
+    for (size_t step = 0; step < step_count; ++step) {
+        ensemble_solver_t solver(grid, velocity, ensemble_buffer);
+        solver.step(dt, u_in, u_out);
+        ensemble_buffer.advance(+1);
+    }
+
+    for (size_t k = 0; k < K; ++k) {
+        Q = vector<double>(n, flows[k]);
+        ring_buffer_t<layer_t> scenario_buffer(2, n);
+        scenario_buffer.previous().vars.cell_double[0] = rho_initial;
+        for (size_t step = 0; step < step_count; ++step) {
+            van_leer_fv_solver solver(*advection_model, scenario_buffer);
+            solver.step(dt, u_in[k], u_out[k]);
+            scenario_buffer.advance(+1);
+        }
+        ASSERT_EQ(scenario_buffer.previous().vars.cell_double[0],
+            ensemble_buffer.previous().vars.cell_double[0].get_scenario_profile(k));
+    }
+
+    velocity[1] = -3 * velocity[0];
+    ensemble_solver_t solver(grid, velocity, ensemble_buffer);
+    ASSERT_THROW(solver.step(dt, u_in, u_out), std::runtime_error);
+}
+
+/// @brief Проверяет, что схема не порождает новых экстремумов 
+/// при переносе ступеньки плотности на трубе 50 км
+/// @tparam Solver Солвер метода конечных объемов
+/// @param flow Объемный расход (знак задает направление потока)
+template <typename Solver>
+inline void check_fv_solver_monotonicity(double flow)
+{
+    simple_pipe_properties simple_pipe;
+    simple_pipe.length = 50e3;
+    simple_pipe.diameter = 0.7;
+    simple_pipe.dx = 100;
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = pipe.profile.getPointCount();
+
+    vector<double> Q(n, flow);
+    PipeQAdvection advection_model(pipe, Q);
+
+    typedef composite_layer_t<typename Solver::var_layer_data, typename Solver::specific_layer> layer_t;
+    ring_buffer_t<layer_t> buffer(2, n);
+    auto& rho_initial = buffer.previous().vars.cell_double[0];
+    for (size_t cell = 0; cell < rho_initial.size(); ++cell) {
+        rho_initial[cell] = cell > n / 3 && cell < n / 2 ? 870 : 850;
+    }
+    const auto& x = advection_model.get_grid();
+    double dt = 0.6 * (x[1] - x[0]) / std::abs(advection_model.getEquationsCoeffs(0, 0));
+
+    for (size_t step = 0; step < 200; ++step) {
+        Solver solver(advection_model, buffer);
+        solver.step(dt, 850, 850);
+        buffer.advance(+1);
+        for (double rho : buffer.previous().vars.cell_double[0]) {
+            ASSERT_GE(rho, 850 - 1e-9);
+            ASSERT_LE(rho, 870 + 1e-9);
+        }
+    }
+}
+
+/// @brief TVD-схемы (ван Леер, superbee) не порождают новых экстремумов в обоих направлениях потока
+TEST(FV_Solver, TVDLimitersPreserveMonotonicity)
+{
+    for (double flow : { 0.5, -0.5 }) {
+        check_fv_solver_monotonicity<van_leer_fv_solver>(flow);
+        check_fv_solver_monotonicity<superbee_fv_solver>(flow);
+    }
+}
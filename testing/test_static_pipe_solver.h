@@ -26,3 +26,620 @@ TEST(Static_Hydraulic_Solver, UseCase)
 
 
 }
+
+/// @brief Источниковый член PQ-модели с партиями по таблицам коэффициентов совпадает 
+/// с прямым расчетом по соседним точкам, в т.ч. после смены профилей плотности и температуры 
+/// и вызова update_tables
+TEST(PipeModelPQConstAreaSortedNonisothermal, TablesMatchDirectSourceTerm)
+{
+    simple_pipe_properties simple_pipe = simple_pipe_properties::sample_district();
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = pipe.profile.getPointCount();
+    const auto& x = pipe.profile.coordinates;
+    for (size_t index = 0; index < n; ++index) {
+        pipe.profile.heights[index] = 50 * std::sin(x[index] / 5000);
+    }
+
+    vector<double> density(n, 850);
+    vector<array<double, 3>> viscosity(n, 
+        viscosity_table_model_t::reconstruct({ 50e-6, 20e-6, 8e-6 }));
+    vector<double> temperature(n, KELVIN_OFFSET + 20);
+    fluid_properties_profile_t oil(density, viscosity);
+    PipeModelPQConstAreaSortedNonisothermal model(pipe, oil, temperature);
+
+    auto direct_source = [&](size_t index, double Q) {
+        double d = pipe.wall.diameter * pipe.adaptation.diameter;
+        double S = pipe.wall.getArea() * pipe.adaptation.diameter * pipe.adaptation.diameter;
+        double v = Q / S;
+        double rho = density[index];
+        double Re = v * d / oil.get_viscosity(index, temperature[index]);
+        double lambda = pipe.resistance_function(Re, pipe.wall.relativeRoughness()) * pipe.adaptation.friction;
+        double tau_w = lambda / 8 * rho * v * abs(v);
+        size_t left = index == 0 ? 0 : index - 1;
+        size_t right = index == n - 1 ? n - 1 : index + 1;
+        double density_gradient = (density[right] - density[left]) / (x[right] - x[left]);
+        double height_gradient = (pipe.profile.heights[right] - pipe.profile.heights[left]) / (x[right] - x[left]);
+        return 2 * S * v * abs(v) / rho * density_gradient - M_PI * d * tau_w / rho - M_G * S * height_gradient;
+    };
+
+    for (size_t step = 0; step < 2; ++step) {
+        for (size_t index : { size_t(0), size_t(1), n / 2, n - 2, n - 1 }) {
+            double Q = 0.5;
+            auto source = model.getSourceTerm(index, { 5e6, Q });
+            ASSERT_EQ(source[0], 0);
+            ASSERT_NEAR(source[1], direct_source(index, Q), 1e-12 * std::abs(direct_source(index, Q)));
+        }
+        // партия более тяжелой нефти вошла в трубу, нефть на входе остыла
+        for (size_t index = 0; index < n / 2; ++index) {
+            density[index] = 870;
+            temperature[index] = KELVIN_OFFSET + 10;
+        }
+        model.update_tables();
+    }
+}
+
+/// @brief Пакетный расчет профиля вязкости совпадает с поточечным для всех видов модели
+/// и пересчитывает только точки, где изменилась температура или партия
+TEST(ViscosityProfileEvaluator, RecalculatesOnlyChangedPoints)
+{
+    size_t n = 100;
+    vector<array<double, 3>> coeffs(n);
+    vector<double> temperature(n);
+    for (size_t index = 0; index < n; ++index) {
+        switch (index % 3) {
+        case 0: coeffs[index] = viscosity_table_model_t::reconstruct({ 50e-6, 20e-6, 8e-6 }); break; // Фогель-Фульчер-Тамман
+        case 1: coeffs[index] = viscosity_table_model_t::reconstruct({ 40e-6, 20e-6, 20e-6 / pow(2, 1.5) }); break; // Филонов-Рейнольс
+        default: coeffs[index] = viscosity_table_model_t::reconstruct({ 15e-6, 15e-6, 15e-6 }); break; // константа
+        }
+        temperature[index] = KELVIN_OFFSET + 5 + 0.3 * index;
+    }
+    ASSERT_FALSE(std::isnan(coeffs[0][2]));
+    ASSERT_TRUE(std::isnan(coeffs[1][2]) && !std::isnan(coeffs[1][1]));
+    ASSERT_TRUE(std::isnan(coeffs[2][1]));
+
+    auto check = [&](const vector<double>& viscosity) {
+        for (size_t index = 0; index < n; ++index) {
+            ASSERT_EQ(viscosity[index], viscosity_table_model_t::calc(coeffs[index], temperature[index]));
+        }
+    };
+
+    viscosity_profile_evaluator_t evaluator;
+    vector<double> viscosity;
+    ASSERT_EQ(evaluator.calc(coeffs, temperature, &viscosity), n);
+    check(viscosity);
+    ASSERT_EQ(evaluator.calc(coeffs, temperature, &viscosity), 0u);
+
+    temperature[10] += 1;
+    temperature[11] += 1;
+    coeffs[50] = coeffs[0]; // сдвиг партий
+    ASSERT_EQ(evaluator.calc(coeffs, temperature, &viscosity), 3u);
+    check(viscosity);
+
+    evaluator.reset();
+    ASSERT_EQ(evaluator.calc(coeffs, temperature, &viscosity), n);
+    check(viscosity);
+}
+
+/// @brief Табличный расчет гидравлического сопротивления во всех режимах течения 
+/// совпадает с формулой Исаева с ошибкой не хуже найденной при построении таблицы; 
+/// подставленный в трубу, дает тот же расход в задаче PP
+TEST(HydraulicResistanceTable, MatchesIsaevFormula)
+{
+    for (double relative_roughness : { 1e-6, 1e-5, 1.4e-4, 1e-3, 1e-2 }) {
+        hydraulic_resistance_table_t table(relative_roughness);
+        ASSERT_LT(table.get_max_relative_error(), 1e-9);
+
+        vector<double> Re;
+        for (double log_Re = -1; log_Re < 9; log_Re += 1e-3) {
+            Re.push_back(pow(10, log_Re));
+        }
+        Re.push_back(-5e4);
+        vector<double> lambda(Re.size());
+        hydraulic_resistance_isaev_tabulated(Re.data(), relative_roughness, lambda.data(), Re.size());
+        for (size_t index = 0; index < Re.size(); ++index) {
+            double exact = hydraulic_resistance_isaev(Re[index], relative_roughness);
+            ASSERT_NEAR(lambda[index], exact, 2 * table.get_max_relative_error() * exact + 1e-15);
+            ASSERT_EQ(lambda[index], hydraulic_resistance_isaev_tabulated(Re[index], relative_roughness));
+        }
+    }
+
+    // при чередовании шероховатостей таблицы не перестраиваются
+    const hydraulic_resistance_table_t* smooth_table = &get_hydraulic_resistance_table(1e-5);
+    const hydraulic_resistance_table_t* rough_table = &get_hydraulic_resistance_table(1e-3);
+    ASSERT_EQ(smooth_table, &get_hydraulic_resistance_table(1e-5));
+    ASSERT_EQ(rough_table, &get_hydraulic_resistance_table(1e-3));
+
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    ring_buffer_t<profile_collection_t<2>> buffer(1, pipe.profile.getPointCount());
+    profile_wrapper<double, 2> layer(get_profiles_pointers(buffer.current().point_double));
+
+    PipeModelPGConstArea exact_model(pipe, oil);
+    double exact_G = solve_pipe_PP(exact_model, 5e6, 1e6, &layer);
+    pipe.resistance_function = hydraulic_resistance_isaev_tabulated;
+    PipeModelPGConstArea tabulated_model(pipe, oil);
+    double tabulated_G = solve_pipe_PP(tabulated_model, 5e6, 1e6, &layer);
+    ASSERT_NEAR(tabulated_G, exact_G, 1e-6 * exact_G);
+}
+
+/// @brief Сравнение быстродействия расчета гидравлического сопротивления по формуле и по таблице
+/// (по одному значению и массивом) на числах Рейнольдса из всех зон. 
+/// Только замер времени, запускается явно: --gtest_also_run_disabled_tests
+TEST(HydraulicResistanceTable, DISABLED_Benchmark)
+{
+    double relative_roughness = 1.4e-4;
+    size_t count = 1000000;
+    vector<double> Re(count);
+    for (size_t index = 0; index < count; ++index) {
+        // значения из разных зон идут вперемешку
+        Re[index] = 1e3 * pow(1e4, static_cast<double>((index * 7919) % 1000) / 1000);
+    }
+    vector<double> exact(count), scalar(count), array(count);
+
+    auto measure = [&](auto calculate) {
+        auto start = std::chrono::steady_clock::now();
+        calculate();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double exact_duration = measure([&]() {
+        for (size_t index = 0; index < count; ++index) {
+            exact[index] = hydraulic_resistance_isaev(Re[index], relative_roughness);
+        }
+        });
+    double scalar_duration = measure([&]() {
+        for (size_t index = 0; index < count; ++index) {
+            scalar[index] = hydraulic_resistance_isaev_tabulated(Re[index], relative_roughness);
+        }
+        });
+    double array_duration = measure([&]() {
+        hydraulic_resistance_isaev_tabulated(Re.data(), relative_roughness, array.data(), count);
+        });
+
+    std::cout << "Isaev formula: " << 1e9 * exact_duration / count << " ns/value" << std::endl;
+    std::cout << "Tabulated, scalar: " << 1e9 * scalar_duration / count << " ns/value" << std::endl;
+    std::cout << "Tabulated, array (table looked up once): " << 1e9 * array_duration / count << " ns/value" << std::endl;
+}
+
+/// @brief Метод Ньютона с производной dPin/dG из того же прохода Эйлера дает тот же расход, что solve_pipe_PP;
+/// производная совпадает с конечной разностью, а начальное приближение с предыдущего шага сокращает число итераций
+TEST(Static_Hydraulic_Solver, NewtonWithSensitivityAndWarmStart)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea model(pipe, oil);
+    ring_buffer_t<profile_collection_t<2>> buffer(1, pipe.profile.getPointCount());
+    profile_wrapper<double, 2> layer(get_profiles_pointers(buffer.current().point_double));
+
+    double Pin = 5e6;
+    double Pout = 1e6;
+    double G = 300;
+    array<double, 2> sensitivity = solve_euler_corrector_sensitivity<2>(model, -1, { Pout, G }, { 0, 1 }, &layer);
+    double Pin_plus = (solve_euler_corrector<2>(model, -1, { Pout, G + 1e-3 }, &layer), layer.profile(0).front());
+    double Pin_minus = (solve_euler_corrector<2>(model, -1, { Pout, G - 1e-3 }, &layer), layer.profile(0).front());
+    ASSERT_NEAR(sensitivity[0], (Pin_plus - Pin_minus) / 2e-3, 1e-5 * std::abs(sensitivity[0]));
+    ASSERT_NEAR(sensitivity[1], 1, 1e-12);
+
+    double expected_G = solve_pipe_PP(model, Pin, Pout, &layer);
+    pipe_PP_newton_result_t cold = solve_pipe_PP_newton(model, Pin, Pout, 0, &layer);
+    ASSERT_TRUE(cold.converged);
+    ASSERT_NEAR(cold.flow, expected_G, 1e-4 * expected_G);
+    ASSERT_NEAR(layer.profile(0).front(), Pin, 1e-2);
+    ASSERT_EQ(layer.profile(1).front(), cold.flow);
+
+    // квазистационарный шаг: давление на входе немного изменилось
+    pipe_PP_newton_result_t warm = solve_pipe_PP_newton(model, Pin + 1e4, Pout, cold.flow, &layer);
+    ASSERT_TRUE(warm.converged);
+    ASSERT_LE(warm.iteration_count, 3);
+    ASSERT_LT(warm.iteration_count, cold.iteration_count);
+    ASSERT_GT(warm.flow, cold.flow);
+
+    pipe_PP_newton_parameters_t parameters;
+    parameters.iteration_count = 1;
+    pipe_PP_newton_result_t limited = solve_pipe_PP_newton(model, Pin, Pout, 0, &layer, parameters);
+    ASSERT_FALSE(limited.converged);
+    ASSERT_EQ(limited.iteration_count, 1u);
+    ASSERT_EQ(limited.flow, 0);
+}
+
+/// @brief Аналитическая производная правой части моделей трубы (с членом dλ/dRe) совпадает 
+/// с численной производной по умолчанию (ode_t::ode_right_party_derivative) во всех режимах течения
+TEST(Static_Hydraulic_Solver, AnalyticRightPartyDerivativeMatchesDifference)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+    size_t n = pipe.profile.getPointCount();
+    const auto& x = pipe.profile.coordinates;
+    for (size_t index = 0; index < n; ++index) {
+        pipe.profile.heights[index] = 50 * std::sin(x[index] / 5000);
+    }
+    oil_parameters_t oil;
+    vector<double> temperature(n, KELVIN_OFFSET + 20);
+
+    vector<double> density(n, 850);
+    for (size_t index = 0; index < n / 2; ++index) {
+        density[index] = 870;
+    }
+    vector<array<double, 3>> viscosity(n,
+        viscosity_table_model_t::reconstruct({ 50e-6, 20e-6, 8e-6 }));
+    fluid_properties_profile_t oil_profile(density, viscosity);
+
+    auto check = [&](const ode_t<2>& model, size_t index, const array<double, 2>& u) {
+        array<double, 2> direction{ 1, 1 };
+        array<double, 2> right_party = model.ode_right_party(index, u);
+        array<double, 2> analytic = model.ode_right_party_derivative(index, u, right_party, direction);
+        array<double, 2> difference = model.ode_t<2>::ode_right_party_derivative(index, u, right_party, direction);
+        double scale = std::max(std::abs(difference[0]), std::abs(difference[1]));
+        ASSERT_GT(scale, 0);
+        for (size_t component = 0; component < 2; ++component) {
+            ASSERT_NEAR(analytic[component], difference[component], 1e-5 * scale);
+        }
+    };
+
+    PipeModelPGConstArea pg_model(pipe, oil);
+    PipeModelPGConstAreaNonIsothermal nonisothermal_model(pipe, oil, temperature);
+    // ламинарный, переходный, турбулентный режимы, обратный поток, квадратичное трение
+    for (double G : { 5.0, 22.0, 100.0, 300.0, -300.0, 50000.0 }) {
+        check(pg_model, n / 2, { 0, G });
+        check(nonisothermal_model, n / 2, { 0, G });
+    }
+
+    PipeModelPQConstAreaSortedNonisothermal pq_model(pipe, oil_profile, temperature);
+    for (double Q : { 0.01, 0.05, 0.3, 1.0, -1.0, 100.0 }) {
+        for (size_t index : { size_t(0), n / 2 - 1, n / 2, n - 1 }) {
+            check(pq_model, index, { 0, Q });
+        }
+    }
+}
+
+/// @brief Пакетный расчет по сетке граничных давлений и вариантов вязкости совпадает 
+/// с поочередным solve_pipe_PP_newton, в том числе при распределении вариантов по потокам
+/// и при табличной формуле сопротивления (считается сразу для массива вариантов)
+TEST(Static_Hydraulic_Solver, BatchMatchesSingleCaseNewton)
+{
+    vector<double(*)(double, double)> resistance_functions{ 
+        hydraulic_resistance_isaev, hydraulic_resistance_isaev_tabulated };
+    for (auto resistance_function : resistance_functions) {
+        pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+        pipe.resistance_function = resistance_function;
+        vector<oil_parameters_t> oils(2);
+        oils[1].viscosity.nominal_viscosity = 30e-6;
+        vector<PipeModelPGConstArea> rheology_models{ PipeModelPGConstArea(pipe, oils[0]), PipeModelPGConstArea(pipe, oils[1]) };
+
+        vector<PipeModelPGConstArea*> models;
+        vector<double> Pin, Pout;
+        for (double inlet = 3e6; inlet <= 6e6; inlet += 0.5e6) {
+            for (double outlet : { 0.5e6, 1e6, 1.5e6 }) {
+                for (PipeModelPGConstArea& model : rheology_models) {
+                    models.push_back(&model);
+                    Pin.push_back(inlet);
+                    Pout.push_back(outlet);
+                }
+            }
+        }
+        size_t case_count = Pin.size();
+
+        static_assert(pipe_model_has_batch_right_party<PipeModelPGConstArea>::value, "");
+        vector<vector<double>> pressure_profiles;
+        auto results = solve_pipe_PP_batch(models, Pin, Pout, {}, &pressure_profiles);
+
+        pipe_PP_batch_parameters_t parallel_parameters;
+        parallel_parameters.batch_size = 4;
+        parallel_parameters.parallel = parallel_settings_t::with_threads(3);
+        parallel_parameters.parallel.chunk_size = 5;
+        vector<vector<double>> parallel_profiles;
+        auto parallel_results = solve_pipe_PP_batch(models, Pin, Pout, {}, &parallel_profiles, parallel_parameters);
+
+        ring_buffer_t<profile_collection_t<2>> buffer(1, pipe.profile.getPointCount());
+        profile_wrapper<double, 2> layer(get_profiles_pointers(buffer.current().point_double));
+        for (size_t k = 0; k < case_count; ++k) {
+            pipe_PP_newton_result_t expected = solve_pipe_PP_newton(*models[k], Pin[k], Pout[k], 0, &layer);
+            ASSERT_TRUE(results[k].converged);
+            ASSERT_EQ(results[k].flow, expected.flow);
+            ASSERT_EQ(results[k].iteration_count, expected.iteration_count);
+            ASSERT_EQ(pressure_profiles[k], layer.profile(0));
+            ASSERT_EQ(parallel_results[k].flow, expected.flow);
+            ASSERT_EQ(parallel_profiles[k], layer.profile(0));
+        }
+        // более вязкая нефть при тех же давлениях течет медленнее
+        ASSERT_LT(results[1].flow, results[0].flow);
+    }
+}
+
+/// @brief Адаптивный метод Дормана-Принса на гладкой задаче с известным решением 
+/// перешагивает много ячеек сетки и восстанавливает решение во всех точках сетки с заданной точностью
+TEST(DormandPrince, MatchesAnalyticSolutionWithFewSteps)
+{
+    // du/dx = -a * cos(x / L) * u, u = u0 * exp(-a * L * sin(x / L))
+    class cosine_decay_ode_t : public ode_t<1> {
+    public:
+        vector<double> grid;
+        double a{ 1e-4 };
+        double L{ 10e3 };
+        cosine_decay_ode_t() {
+            for (size_t index = 0; index <= 1000; ++index) {
+                grid.push_back(100.0 * index);
+            }
+        }
+        virtual const vector<double>& get_grid() const override {
+            return grid;
+        }
+        double calc(double x, double u) const {
+            return -a * cos(x / L) * u;
+        }
+        virtual right_party_type ode_right_party(size_t grid_index, const var_type& u) const override {
+            return calc(grid[grid_index], u);
+        }
+        virtual right_party_type ode_right_party_at(size_t cell_index, double cell_fraction,
+            const var_type& u) const override
+        {
+            return calc(grid[cell_index] + cell_fraction * (grid[cell_index + 1] - grid[cell_index]), u);
+        }
+    };
+
+    cosine_decay_ode_t ode;
+    double u0 = 2;
+    for (int direction : { +1, -1 }) {
+        vector<double> u(ode.grid.size());
+        double x0 = direction > 0 ? ode.grid.front() : ode.grid.back();
+        double initial = u0 * exp(-ode.a * ode.L * sin(x0 / ode.L));
+        ode_adaptive_parameters_t parameters;
+        parameters.absolute_tolerance = 1e-9;
+        ode_adaptive_result_t statistics = solve_dormand_prince<1>(ode, direction, initial, &u, parameters);
+
+        ASSERT_LT(statistics.accepted_step_count, ode.grid.size() / 10);
+        for (size_t index = 0; index < ode.grid.size(); ++index) {
+            double exact = u0 * exp(-ode.a * ode.L * sin(ode.grid[index] / ode.L));
+            ASSERT_NEAR(u[index], exact, 1e-6 * exact);
+        }
+    }
+}
+
+/// @brief Адаптивный метод на трубе с рельефом (правая часть между точками сетки интерполируется)
+/// дает профиль давления, близкий к методу Эйлера с предиктором-корректором, за меньшее число шагов
+TEST(DormandPrince, PipeProfileMatchesEulerCorrector)
+{
+    simple_pipe_properties simple_pipe = simple_pipe_properties::sample_district();
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = pipe.profile.getPointCount();
+    const auto& x = pipe.profile.coordinates;
+    for (size_t index = 0; index < n; ++index) {
+        pipe.profile.heights[index] = 50 * std::sin(x[index] / 50e3);
+    }
+    vector<double> density(n, 850);
+    vector<array<double, 3>> viscosity(n, viscosity_table_model_t::reconstruct({ 50e-6, 20e-6, 8e-6 }));
+    vector<double> temperature(n, KELVIN_OFFSET + 20);
+    fluid_properties_profile_t oil(density, viscosity);
+    PipeModelPQConstAreaSortedNonisothermal model(pipe, oil, temperature);
+
+    ring_buffer_t<profile_collection_t<2>> buffer(2, n);
+    profile_wrapper<double, 2> euler_layer(get_profiles_pointers(buffer.current().point_double));
+    profile_wrapper<double, 2> adaptive_layer(get_profiles_pointers(buffer.previous().point_double));
+
+    solve_euler_corrector<2>(model, -1, { 1e6, 0.5 }, &euler_layer);
+    ode_adaptive_parameters_t parameters;
+    parameters.absolute_tolerance = 1e-2;
+    ode_adaptive_result_t statistics = solve_dormand_prince<2>(model, -1, { 1e6, 0.5 }, &adaptive_layer, parameters);
+
+    ASSERT_LT(statistics.accepted_step_count, n / 10);
+    double pressure_drop = euler_layer.profile(0).front() - euler_layer.profile(0).back();
+    for (size_t index = 0; index < n; ++index) {
+        ASSERT_NEAR(adaptive_layer.profile(0)[index], euler_layer.profile(0)[index], 1e-4 * pressure_drop);
+        ASSERT_EQ(adaptive_layer.profile(1)[index], 0.5);
+    }
+}
+
+/// @brief Градиент давления по трубе с партиями при заданном объемном расходе (не зависит от давления)
+class pipe_PQ_parties_ode_t : public ode_t<1> {
+public:
+    static constexpr bool has_state_independent_right_party = true;
+    const pipe_properties_t& pipe;
+    const vector<double>& density;
+    double flow;
+    pipe_PQ_parties_ode_t(const pipe_properties_t& pipe, const vector<double>& density, double flow)
+        : pipe(pipe)
+        , density(density)
+        , flow(flow)
+    {}
+    virtual const vector<double>& get_grid() const override {
+        return pipe.profile.coordinates;
+    }
+    virtual right_party_type ode_right_party(size_t grid_index, const var_type& pressure) const override {
+        double rho = density[grid_index];
+        double v = flow / pipe.wall.getArea();
+        double Re = v * pipe.wall.diameter / 15e-6;
+        double lambda = pipe.resistance_function(Re, pipe.wall.relativeRoughness());
+        double tau_w = lambda / 8 * rho * v * abs(v);
+        size_t neighbour = grid_index + 1 < pipe.profile.getPointCount() ? grid_index + 1 : grid_index - 1;
+        double height_derivative = (pipe.profile.heights[neighbour] - pipe.profile.heights[grid_index])
+            / (pipe.profile.coordinates[neighbour] - pipe.profile.coordinates[grid_index]);
+        return -4 * tau_w / pipe.wall.diameter - rho * M_G * height_derivative;
+    }
+};
+
+/// @brief Профиль трубы с перепадом высот и партиями разной плотности для pipe_PQ_parties_ode_t
+/// @param length Длина трубы
+/// @param density Плотность по точкам, меняется через каждые batch_points точек
+inline pipe_properties_t prepare_parties_pipe(double length, size_t batch_points, vector<double>* density)
+{
+    simple_pipe_properties simple_pipe = simple_pipe_properties::sample_district();
+    simple_pipe.length = length;
+    simple_pipe.dx = 10;
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe);
+    size_t n = pipe.profile.getPointCount();
+    density->resize(n);
+    for (size_t index = 0; index < n; ++index) {
+        pipe.profile.heights[index] = 30 * std::sin(pipe.profile.coordinates[index] / 20e3);
+        (*density)[index] = (index / batch_points) % 2 == 0 ? 850 : 870;
+    }
+    return pipe;
+}
+
+/// @brief Профиль давления с градиентом, не зависящим от давления, префиксной суммой совпадает с методом Эйлера 
+/// с точностью до порядка сложения и побитово одинаков при любом числе потоков
+TEST(EulerScan, MatchesEulerForStateIndependentGradient)
+{
+    static_assert(ode_has_state_independent_right_party<pipe_PQ_parties_ode_t>::value, "");
+    static_assert(!ode_has_state_independent_right_party<PipeModelPGConstArea>::value, "");
+
+    vector<double> density;
+    pipe_properties_t pipe = prepare_parties_pipe(100e3, 1000, &density);
+    size_t n = pipe.profile.getPointCount();
+    pipe_PQ_parties_ode_t ode(pipe, density, 0.5);
+
+    for (int direction : { +1, -1 }) {
+        for (bool use_corrector : { false, true }) {
+            vector<double> euler(n), serial(n), parallel(n);
+            if (use_corrector) {
+                solve_euler_corrector<1>(ode, direction, 6e6, &euler);
+            }
+            else {
+                solve_euler<1>(ode, direction, 6e6, &euler);
+            }
+            solve_euler_scan(ode, direction, 6e6, &serial, parallel_settings_t(), use_corrector);
+            solve_euler_scan(ode, direction, 6e6, &parallel, parallel_settings_t::with_threads(4), use_corrector);
+
+            ASSERT_EQ(serial, parallel);
+            for (size_t index = 0; index < n; ++index) {
+                ASSERT_NEAR(serial[index], euler[index], 1e-9 * 6e6);
+            }
+        }
+    }
+}
+
+/// @brief Сравнение быстродействия префиксной суммы и метода Эйлера на сетке 100 тыс. точек.
+/// Только замер времени, запускается явно: --gtest_also_run_disabled_tests
+TEST(EulerScan, DISABLED_Benchmark)
+{
+    vector<double> density;
+    pipe_properties_t pipe = prepare_parties_pipe(1000e3, 10000, &density);
+    size_t n = pipe.profile.getPointCount();
+    pipe_PQ_parties_ode_t ode(pipe, density, 0.5);
+
+    for (int direction : { +1, -1 }) {
+        for (bool use_corrector : { false, true }) {
+            vector<double> euler(n), serial(n), parallel(n);
+            auto start = std::chrono::steady_clock::now();
+            if (use_corrector) {
+                solve_euler_corrector<1>(ode, direction, 6e6, &euler);
+            }
+            else {
+                solve_euler<1>(ode, direction, 6e6, &euler);
+            }
+            auto middle = std::chrono::steady_clock::now();
+            solve_euler_scan(ode, direction, 6e6, &serial, parallel_settings_t(), use_corrector);
+            auto serial_finish = std::chrono::steady_clock::now();
+            solve_euler_scan(ode, direction, 6e6, &parallel, parallel_settings_t::with_threads(4), use_corrector);
+            auto parallel_finish = std::chrono::steady_clock::now();
+
+            std::cout << "Points: " << n << ", direction " << direction << (use_corrector ? ", corrector" : "")
+                << ": Euler " << 1e3 * std::chrono::duration<double>(middle - start).count() << " ms"
+                << ", scan " << 1e3 * std::chrono::duration<double>(serial_finish - middle).count() << " ms"
+                << ", scan on 4 threads " << 1e3 * std::chrono::duration<double>(parallel_finish - serial_finish).count()
+                << " ms" << std::endl;
+        }
+    }
+}
+
+/// @brief Множественная стрельба на участке ТУ 700 км совпадает с последовательным методом Эйлера 
+/// с предиктором-корректором, сходится за несколько проходов, а с приближением из предыдущего профиля - за один
+TEST(MultipleShooting, MatchesEulerCorrectorOnLongPipe)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea model(pipe, oil);
+    size_t n = pipe.profile.getPointCount();
+
+    ring_buffer_t<profile_collection_t<2>> buffer(2, n);
+    profile_wrapper<double, 2> euler_layer(get_profiles_pointers(buffer.current().point_double));
+    profile_wrapper<double, 2> shooting_layer(get_profiles_pointers(buffer.previous().point_double));
+
+    array<double, 2> initial_condition{ 1e6, 400 };
+    solve_euler_corrector<2>(model, -1, initial_condition, &euler_layer);
+
+    ode_multiple_shooting_parameters_t parameters;
+    parameters.segment_count = 16;
+    ode_multiple_shooting_result_t result = solve_euler_corrector_multiple_shooting<2>(
+        model, -1, initial_condition, &shooting_layer, parallel_settings_t::with_threads(4), parameters);
+    ASSERT_TRUE(result.converged);
+    ASSERT_LE(result.iteration_count, 3);
+
+    double pressure_drop = euler_layer.profile(0).front() - euler_layer.profile(0).back();
+    for (size_t index = 0; index < n; ++index) {
+        ASSERT_NEAR(shooting_layer.profile(0)[index], euler_layer.profile(0)[index], 1e-9 * pressure_drop);
+        ASSERT_NEAR(shooting_layer.profile(1)[index], euler_layer.profile(1)[index], 1e-9);
+    }
+
+    // следующий шаг по времени с тем же режимом: приближение на стыках из предыдущего профиля
+    parameters.use_result_as_initial_guess = true;
+    ode_multiple_shooting_result_t warm_result = solve_euler_corrector_multiple_shooting<2>(
+        model, -1, initial_condition, &shooting_layer, parallel_settings_t::with_threads(4), parameters);
+    ASSERT_TRUE(warm_result.converged);
+    ASSERT_EQ(warm_result.iteration_count, 1u);
+}
+
+/// @brief Обертка модели трубы, считающая вызовы правой части. Производная по направлению 
+/// берется из модели (аналитическая) или считается разностью по умолчанию
+class right_party_counting_ode_t : public ode_t<2> {
+    const ode_t<2>& model;
+    const bool analytic_derivative;
+public:
+    /// @brief Количество вызовов ode_right_party
+    mutable size_t right_party_count{ 0 };
+
+    right_party_counting_ode_t(const ode_t<2>& model, bool analytic_derivative)
+        : model(model)
+        , analytic_derivative(analytic_derivative)
+    {}
+    virtual const vector<double>& get_grid() const override {
+        return model.get_grid();
+    }
+    virtual right_party_type ode_right_party(size_t grid_index, const var_type& point_vector) const override {
+        right_party_count++;
+        return model.ode_right_party(grid_index, point_vector);
+    }
+    virtual right_party_type ode_right_party_derivative(size_t grid_index, const var_type& point_vector,
+        const right_party_type& right_party, const var_type& direction) const override
+    {
+        return analytic_derivative
+            ? model.ode_right_party_derivative(grid_index, point_vector, right_party, direction)
+            : ode_t<2>::ode_right_party_derivative(grid_index, point_vector, right_party, direction);
+    }
+};
+
+/// @brief Множественная стрельба с аналитическим якобианом модели трубы вызывает правую часть 
+/// только для самих профилей (2 раза на шаг сетки), а с разностной производной - еще по разу 
+/// на каждый столбец матрицы чувствительности в предикторе и корректоре, т.е. втрое чаще.
+/// Результаты совпадают
+TEST(MultipleShooting, AnalyticJacobianSavesRightPartyCalls)
+{
+    pipe_properties_t pipe = pipe_properties_t::build_simple_pipe(simple_pipe_properties::sample_district());
+    oil_parameters_t oil;
+    PipeModelPGConstArea model(pipe, oil);
+    size_t n = pipe.profile.getPointCount();
+
+    ring_buffer_t<profile_collection_t<2>> buffer(2, n);
+    profile_wrapper<double, 2> analytic_layer(get_profiles_pointers(buffer.current().point_double));
+    profile_wrapper<double, 2> difference_layer(get_profiles_pointers(buffer.previous().point_double));
+
+    array<double, 2> initial_condition{ 1e6, 400 };
+    ode_multiple_shooting_parameters_t parameters;
+    parameters.segment_count = 16;
+
+    right_party_counting_ode_t analytic_ode(model, true);
+    ode_multiple_shooting_result_t analytic = solve_euler_corrector_multiple_shooting<2>(
+        analytic_ode, -1, initial_condition, &analytic_layer, parallel_settings_t::with_threads(1), parameters);
+    right_party_counting_ode_t difference_ode(model, false);
+    ode_multiple_shooting_result_t difference = solve_euler_corrector_multiple_shooting<2>(
+        difference_ode, -1, initial_condition, &difference_layer, parallel_settings_t::with_threads(1), parameters);
+
+    ASSERT_TRUE(analytic.converged);
+    ASSERT_TRUE(difference.converged);
+    ASSERT_EQ(analytic.iteration_count, difference.iteration_count);
+    size_t step_count = n - 1;
+    ASSERT_EQ(analytic_ode.right_party_count, 2 * step_count * analytic.iteration_count);
+    ASSERT_EQ(difference_ode.right_party_count, 3 * analytic_ode.right_party_count);
+
+    double pressure_drop = analytic_layer.profile(0).front() - analytic_layer.profile(0).back();
+    for (size_t index = 0; index < n; ++index) {
+        ASSERT_NEAR(analytic_layer.profile(0)[index], difference_layer.profile(0)[index], 1e-9 * pressure_drop);
+    }
+}